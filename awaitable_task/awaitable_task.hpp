@@ -27,12 +27,16 @@
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <exception>
 #include <forward_list>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <queue>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -66,6 +70,13 @@ namespace dsa
      * make_ready_task and make_awaitable_task, both of which return a pair of
      * the newly constructed awaitable_task and a std::future object to the
      * return value.
+     *
+     * The combinators then and when_all build on make_awaitable_task for the
+     * common shapes of task graphs: then continues a single future with a
+     * callable, and when_all gathers the values of several futures into a
+     * tuple. Both have std::allocator_arg_t overloads, so a large graph can
+     * draw all of its continuation objects from one caller-supplied pool
+     * allocator instead of performing a separate heap allocation per node.
      */
     class awaitable_task
     {
@@ -78,24 +89,62 @@ namespace dsa
         struct ready_task_tag {};
         struct awaitable_task_tag {};
 
+        /*
+         * packs the values produced by a set of futures into a tuple; used
+         * as the continuation body of when_all.
+         */
+        struct collect_
+        {
+            template <class ... Ts>
+            std::tuple <typename std::decay <Ts>::type...>
+            operator() (Ts && ... ts) const
+            {
+                return std::tuple <typename std::decay <Ts>::type...> (
+                    std::forward <Ts> (ts)...
+                );
+            }
+        };
+
     public:
-        awaitable_task (void) = default;
-        ~awaitable_task (void) = default;
+        awaitable_task (void) noexcept
+            : _t (nullptr)
+        {}
+
+        ~awaitable_task (void)
+        {
+            this->reset_ ();
+        }
 
         awaitable_task (awaitable_task const &) = delete;
-        awaitable_task (awaitable_task &&) noexcept = default;
+
+        awaitable_task (awaitable_task && other) noexcept
+            : _t (nullptr)
+        {
+            this->adopt_ (other);
+        }
 
         awaitable_task & operator= (awaitable_task const &) = delete;
-        awaitable_task & operator= (awaitable_task &&) noexcept = default;
+
+        awaitable_task & operator= (awaitable_task && other) noexcept
+        {
+            if (this != &other) {
+                this->reset_ ();
+                this->adopt_ (other);
+            }
+
+            return *this;
+        }
 
         void swap (awaitable_task & other) noexcept
         {
-            std::swap (this->_t, other._t);
+            awaitable_task tmp (std::move (other));
+            other = std::move (*this);
+            *this = std::move (tmp);
         }
 
         operator bool (void) const noexcept
         {
-            return static_cast <bool> (this->_t);
+            return this->_t != nullptr;
         }
 
         template <class>
@@ -163,7 +212,8 @@ namespace dsa
             using model_type = awaitable_task_model <
                 typename std::result_of <
                     F (decay_if_future <Args>...)
-                >::type (decay_if_future <Args>...)
+                >::type (decay_if_future <Args>...),
+                Args...
             >;
 
             awaitable_task t (
@@ -192,7 +242,8 @@ namespace dsa
             using model_type = awaitable_task_model <
                 typename std::result_of <
                     F (decay_if_future <Args>...)
-                >::type (decay_if_future <Args>...)
+                >::type (decay_if_future <Args>...),
+                Args...
             >;
 
             awaitable_task t (
@@ -203,6 +254,35 @@ namespace dsa
             return pair_type (std::move (t), std::move (fut));
         }
 
+        /*
+         * the combinators are declared as friends here and defined at
+         * namespace scope below so that they are found by ordinary lookup
+         * as well as by argument dependent lookup.
+         */
+        template <class T, class F>
+        friend std::pair <
+            awaitable_task,
+            std::future <typename std::result_of <F (T)>::type>
+        > then (std::future <T> && fut, F && f);
+
+        template <class Allocator, class T, class F>
+        friend std::pair <
+            awaitable_task,
+            std::future <typename std::result_of <F (T)>::type>
+        > then (std::allocator_arg_t, Allocator const & alloc,
+                std::future <T> && fut, F && f);
+
+        template <class ... Ts>
+        friend std::pair <
+            awaitable_task, std::future <std::tuple <Ts...>>
+        > when_all (std::future <Ts> && ... futs);
+
+        template <class Allocator, class ... Ts>
+        friend std::pair <
+            awaitable_task, std::future <std::tuple <Ts...>>
+        > when_all (std::allocator_arg_t, Allocator const & alloc,
+                    std::future <Ts> && ... futs);
+
         void operator() (void)
         {
             if (this->_t)
@@ -211,7 +291,7 @@ namespace dsa
                 throw std::logic_error ("bad task access");
         }
 
-        bool ready (void) const noexcept
+        bool ready (void) const
         {
             if (this->_t)
                 return this->_t->ready_ ();
@@ -222,60 +302,75 @@ namespace dsa
     private:
         template <class F, class ... Args>
         awaitable_task (ready_task_tag, F && f, Args && ... args)
-            : _t (
-                new ready_task_model <
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                ready_task_model <
                     typename std::result_of <F (Args...)>::type (Args...)
-                > (std::forward <F> (f), std::forward <Args> (args)...)
-            )
-        {}
+                >
+            > (std::forward <F> (f), std::forward <Args> (args)...);
+        }
 
         template <class Allocator, class F, class ... Args>
         awaitable_task (ready_task_tag,
               std::allocator_arg_t,
               Allocator const & alloc,
               F && f, Args && ... args)
-            : _t (
-                new ready_task_model <
-                    typename std::result_of <F (Args...)>::type (Args...)
-                > (std::allocator_arg_t (), alloc,
-                   std::forward <F> (f), std::forward <Args> (args)...)
-            )
+            : _t (nullptr)
         {
+            this->emplace_ <
+                ready_task_model <
+                    typename std::result_of <F (Args...)>::type (Args...)
+                >
+            > (std::allocator_arg_t (), alloc,
+               std::forward <F> (f), std::forward <Args> (args)...);
         }
 
         template <class F, class ... Args>
         awaitable_task (awaitable_task_tag, F && f, Args && ... args)
-            : _t (
-                new awaitable_task_model <
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                awaitable_task_model <
                     typename std::result_of <
                         F (decay_if_future <Args>...)
                     >::type (decay_if_future <Args>...),
                     Args...
-                > (std::forward <F> (f), std::forward <Args> (args)...)
-            )
-        {}
+                >
+            > (std::forward <F> (f), std::forward <Args> (args)...);
+        }
 
         template <class Allocator, class F, class ... Args>
         awaitable_task (awaitable_task_tag,
               std::allocator_arg_t,
               Allocator const & alloc,
               F && f, Args && ... args)
-            : _t (
-                new awaitable_task_model <
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                awaitable_task_model <
                     typename std::result_of <
                         F (decay_if_future <Args>...)
                     >::type (decay_if_future <Args>...),
                     Args...
-                > (std::allocator_arg_t (), alloc,
-                   std::forward <F> (f), std::forward <Args> (args)...)
-            )
-        {}
+                >
+            > (std::allocator_arg_t (), alloc,
+               std::forward <F> (f), std::forward <Args> (args)...);
+        }
 
         struct task_concept
         {
             virtual ~task_concept (void) noexcept {}
             virtual void invoke_ (void) = 0;
             virtual bool ready_ (void) const noexcept = 0;
+
+            /*
+             * relocates the model into the given small-buffer storage,
+             * returning its new location; called only for models selected
+             * for in-object placement, which are nothrow move
+             * constructible by construction.
+             */
+            virtual task_concept * move_into_ (void * storage) noexcept = 0;
         };
 
         template <class> struct ready_task_model;
@@ -306,6 +401,11 @@ namespace dsa
                          std::forward <Args> (args)...)
             {}
 
+            std::future <R> get_future (void)
+            {
+                return this->_f.get_future ();
+            }
+
             void invoke_ (void) override
             {
                 utility::apply (this->_f, this->_args);
@@ -316,6 +416,11 @@ namespace dsa
                 return true;
             }
 
+            task_concept * move_into_ (void * storage) noexcept override
+            {
+                return new (storage) ready_task_model (std::move (*this));
+            }
+
         private:
             std::packaged_task <R (Args...)> _f;
             std::tuple <Args...> _args;
@@ -348,6 +453,11 @@ namespace dsa
                          std::forward <Args> (args)...)
             {}
 
+            std::future <R> get_future (void)
+            {
+                return this->_f.get_future ();
+            }
+
             void invoke_ (void) override { this->do_invoke_ (); }
 
             bool ready_ (void) const noexcept override
@@ -355,6 +465,11 @@ namespace dsa
                 return this->do_ready_ ();
             }
 
+            task_concept * move_into_ (void * storage) noexcept override
+            {
+                return new (storage) awaitable_task_model (std::move (*this));
+            }
+
         private:
             template <class A, class T>
             static inline auto call_get (T && t) noexcept
@@ -364,10 +479,17 @@ namespace dsa
             }
 
             template <class A, class T>
-            static inline auto call_get (std::future <T> && t) noexcept
-                -> decltype (std::forward <A> (std::move (t).get ()))
+            static inline auto call_get (std::future <T> && t)
+                -> decltype (std::move (t).get ())
             {
-                return std::forward <A> (std::move (t).get ());
+                return std::move (t).get ();
+            }
+
+            inline void do_invoke_ (void)
+            {
+                this->do_invoke_ (
+                    utility::make_index_sequence <sizeof... (FutArgs)> {}
+                );
             }
 
             template <std::size_t ... I>
@@ -390,6 +512,13 @@ namespace dsa
                     std::future_status::ready;
             }
 
+            inline bool do_ready_ (void) const noexcept
+            {
+                return this->do_ready_ (
+                    utility::make_index_sequence <sizeof... (FutArgs)> {}
+                );
+            }
+
             template <std::size_t ... I>
             inline bool do_ready_ (utility::index_sequence <I...>) const
                 noexcept
@@ -405,9 +534,199 @@ namespace dsa
             std::tuple <FutArgs...> _args;
         };
 
-        std::unique_ptr <task_concept> _t;
+        /*
+         * models at most this large (and no more strictly aligned than
+         * std::max_align_t) are constructed in the in-object buffer rather
+         * than on the heap; the bound comfortably fits the common case of a
+         * packaged_task plus a few bound arguments or futures.
+         */
+        static constexpr std::size_t small_buffer_size = 64;
+
+        template <class Model>
+        static constexpr bool fits_small_buffer_ (void)
+        {
+            /*
+             * only nothrow move constructible models are placed in the
+             * buffer, so that moving a task can remain noexcept.
+             */
+            return sizeof (Model) <= small_buffer_size &&
+                   alignof (Model) <= alignof (std::max_align_t) &&
+                   std::is_nothrow_move_constructible <Model>::value;
+        }
+
+        bool small_ (void) const noexcept
+        {
+            return static_cast <void const *> (this->_t) ==
+                   static_cast <void const *> (&this->_storage);
+        }
+
+        /* dispatch on the fit so only the taken branch is instantiated */
+        template <class Model, class ... Ts>
+        void emplace_ (Ts && ... ts)
+        {
+            this->emplace_impl_ <Model> (
+                std::integral_constant <
+                    bool, fits_small_buffer_ <Model> ()
+                > {},
+                std::forward <Ts> (ts)...
+            );
+        }
+
+        template <class Model, class ... Ts>
+        void emplace_impl_ (std::true_type, Ts && ... ts)
+        {
+            this->_t = new (static_cast <void *> (&this->_storage))
+                Model (std::forward <Ts> (ts)...);
+        }
+
+        template <class Model, class ... Ts>
+        void emplace_impl_ (std::false_type, Ts && ... ts)
+        {
+            this->_t = new Model (std::forward <Ts> (ts)...);
+        }
+
+        void reset_ (void) noexcept
+        {
+            if (this->_t) {
+                if (this->small_ ())
+                    this->_t->~task_concept ();
+                else
+                    delete this->_t;
+
+                this->_t = nullptr;
+            }
+        }
+
+        /* takes over other's model, relocating it if it lives in-object */
+        void adopt_ (awaitable_task & other) noexcept
+        {
+            if (!other._t) {
+                this->_t = nullptr;
+            } else if (other.small_ ()) {
+                this->_t = other._t->move_into_ (
+                    static_cast <void *> (&this->_storage)
+                );
+                other.reset_ ();
+            } else {
+                this->_t = other._t;
+                other._t = nullptr;
+            }
+        }
+
+        task_concept * _t;
+        typename std::aligned_storage <
+            small_buffer_size, alignof (std::max_align_t)
+        >::type _storage;
     };
 
+    /*
+     * Creates an awaitable_task continuing the given future: once the future
+     * is fulfilled the task is ready, and invoking it calls f with the
+     * future's value. Returns the task together with a future to f's result,
+     * so continuations compose by chaining then calls.
+     */
+    template <class T, class F>
+    std::pair <
+        awaitable_task,
+        std::future <typename std::result_of <F (T)>::type>
+    > then (std::future <T> && fut, F && f)
+    {
+        using pair_type = std::pair <
+            awaitable_task,
+            std::future <typename std::result_of <F (T)>::type>
+        >;
+        using model_type = awaitable_task::awaitable_task_model <
+            typename std::result_of <F (T)>::type (T), std::future <T>
+        >;
+
+        awaitable_task t (
+            awaitable_task::awaitable_task_tag (),
+            std::forward <F> (f), std::move (fut)
+        );
+        auto res = dynamic_cast <model_type &> (*t._t).get_future ();
+        return pair_type (std::move (t), std::move (res));
+    }
+
+    /*
+     * Creates an awaitable_task continuing the given future, with the
+     * continuation object constructed through the provided allocator; see
+     * the non-allocator overload above.
+     */
+    template <class Allocator, class T, class F>
+    std::pair <
+        awaitable_task,
+        std::future <typename std::result_of <F (T)>::type>
+    > then (std::allocator_arg_t, Allocator const & alloc,
+            std::future <T> && fut, F && f)
+    {
+        using pair_type = std::pair <
+            awaitable_task,
+            std::future <typename std::result_of <F (T)>::type>
+        >;
+        using model_type = awaitable_task::awaitable_task_model <
+            typename std::result_of <F (T)>::type (T), std::future <T>
+        >;
+
+        awaitable_task t (
+            awaitable_task::awaitable_task_tag (), std::allocator_arg_t (),
+            alloc, std::forward <F> (f), std::move (fut)
+        );
+        auto res = dynamic_cast <model_type &> (*t._t).get_future ();
+        return pair_type (std::move (t), std::move (res));
+    }
+
+    /*
+     * Creates an awaitable_task gathering the values of the given futures:
+     * the task is ready once every future is fulfilled, and invoking it
+     * packs the values into a tuple in argument order. Returns the task
+     * together with a future to that tuple.
+     */
+    template <class ... Ts>
+    std::pair <
+        awaitable_task, std::future <std::tuple <Ts...>>
+    > when_all (std::future <Ts> && ... futs)
+    {
+        using pair_type = std::pair <
+            awaitable_task, std::future <std::tuple <Ts...>>
+        >;
+        using model_type = awaitable_task::awaitable_task_model <
+            std::tuple <Ts...> (Ts...), std::future <Ts>...
+        >;
+
+        awaitable_task t (
+            awaitable_task::awaitable_task_tag (),
+            awaitable_task::collect_ {}, std::move (futs)...
+        );
+        auto res = dynamic_cast <model_type &> (*t._t).get_future ();
+        return pair_type (std::move (t), std::move (res));
+    }
+
+    /*
+     * Creates an awaitable_task gathering the values of the given futures,
+     * with the continuation object constructed through the provided
+     * allocator; see the non-allocator overload above.
+     */
+    template <class Allocator, class ... Ts>
+    std::pair <
+        awaitable_task, std::future <std::tuple <Ts...>>
+    > when_all (std::allocator_arg_t, Allocator const & alloc,
+                std::future <Ts> && ... futs)
+    {
+        using pair_type = std::pair <
+            awaitable_task, std::future <std::tuple <Ts...>>
+        >;
+        using model_type = awaitable_task::awaitable_task_model <
+            std::tuple <Ts...> (Ts...), std::future <Ts>...
+        >;
+
+        awaitable_task t (
+            awaitable_task::awaitable_task_tag (), std::allocator_arg_t (),
+            alloc, awaitable_task::collect_ {}, std::move (futs)...
+        );
+        auto res = dynamic_cast <model_type &> (*t._t).get_future ();
+        return pair_type (std::move (t), std::move (res));
+    }
+
     /*
      * awaitable_task_system; a work-stealing tasking system for awaitable_tasks
      * partly inspired by Sean Parent's "Better Code: Concurrency" talk; see
@@ -416,36 +735,19 @@ namespace dsa
     template <class Allocator = std::allocator <awaitable_task>>
     class awaitable_task_system
     {
+        /*
+         * holds only tasks that are ready to run; tasks still waiting on
+         * futures live in the system-wide pending list until a completion
+         * (or an idle worker's sweep) moves them here, so pops never rescan
+         * not-ready work.
+         */
         class task_queue
         {
-            using iterator_type =
-                typename std::forward_list <awaitable_task>::iterator;
-
-            std::forward_list <awaitable_task> tasks_;
-            iterator_type last_;
+            std::queue <awaitable_task> tasks_;
             std::condition_variable cv_;
             std::mutex mutex_;
             std::atomic_bool done_ {false};
 
-            /* rotates the first element of the list onto the end */
-            void rotate_with_ (std::forward_list <awaitable_task> & side_buf)
-            {
-                /* zero or one element list -- trivial to rotate */
-                if (this->tasks_.empty () ||
-                        this->last_ == this->tasks_.begin ())
-                    return;
-
-                side_buf.splice_after (side_buf.begin (), this->tasks_);
-                this->tasks_.splice_after (
-                    this->tasks_.begin (), side_buf,
-                    side_buf.begin (), side_buf.end ()
-                );
-
-                auto new_last = side_buf.begin ();
-                this->tasks_.splice_after (this->last_, side_buf);
-                this->last_ = new_last;
-            }
-
         public:
             task_queue (void)
                 : tasks_ {}
@@ -455,7 +757,6 @@ namespace dsa
 
             task_queue (task_queue && other) noexcept
                 : tasks_ (std::move (other).tasks_)
-                , last_  (std::move (other).last_)
                 , done_  (other.done_.load ())
             {}
 
@@ -465,6 +766,25 @@ namespace dsa
                 this->cv_.notify_all ();
             }
 
+            bool done (void) const noexcept
+            {
+                return this->done_.load ();
+            }
+
+            /*
+             * blocks briefly until new work may be available or done has
+             * been signaled; bounded so that an idle worker periodically
+             * sweeps the pending list for dependencies completed outside
+             * the system.
+             */
+            void wait_for_work (void)
+            {
+                std::unique_lock <std::mutex> lock (this->mutex_);
+                if (this->tasks_.empty () && !this->done_) {
+                    this->cv_.wait_for (lock, std::chrono::milliseconds (1));
+                }
+            }
+
             std::pair <bool, awaitable_task> try_pop (void)
             {
                 std::unique_lock <std::mutex>
@@ -473,7 +793,7 @@ namespace dsa
                     return std::make_pair (false, awaitable_task {});
                 } else {
                     auto t = std::move (this->tasks_.front ());
-                    this->tasks_.pop_front ();
+                    this->tasks_.pop ();
                     return std::make_pair (true, std::move (t));
                 }
             }
@@ -486,14 +806,7 @@ namespace dsa
                     if (!lock)
                         return false;
 
-                    if (this->tasks_.empty ()) {
-                        this->tasks_.emplace_front (std::move (t));
-                        this->last_ = this->tasks_.begin ();
-                    } else {
-                        this->last_ = this->tasks_.emplace_after (
-                            this->last_, std::move (t)
-                        );
-                    }
+                    this->tasks_.emplace (std::move (t));
                 }
 
                 this->cv_.notify_one ();
@@ -503,48 +816,11 @@ namespace dsa
             std::pair <bool, awaitable_task> pop (void)
             {
                 std::unique_lock <std::mutex> lock (this->mutex_);
-                while (this->tasks_.empty () && !this->done_)
-                    this->cv_.wait (lock);
-
                 if (this->tasks_.empty ())
                     return std::make_pair (false, awaitable_task {});
 
-                auto iter = this->tasks_.begin ();
-                auto const old_last = this->last_;
-                std::forward_list <awaitable_task> side_buf;
-
-                if (iter->ready ()) {
-                    auto t = std::move (*iter);
-                    this->tasks_.pop_front ();
-                    return std::make_pair (true, std::move (t));
-                } else {
-                    this->rotate_with_ (side_buf);
-                }
-
-                for (auto lag = iter++; lag != old_last; lag = iter++) {
-                    if (iter->ready ()) {
-                        if (this->last_ == iter)
-                            this->last_ = lag;
-                        auto t = std::move (*iter);
-                        this->tasks_.erase_after (lag);
-                        return std::make_pair (true, std::move (t));
-                    } else {
-                        this->rotate_with_ (side_buf);
-                    }
-                }
-
-                /*
-                 * If we get to this point the best we can do is pop from the
-                 * front of the task list, release the lock, and wait for the
-                 * task to be ready.
-                 */
                 auto t = std::move (this->tasks_.front ());
-                this->tasks_.pop_front ();
-                lock.unlock ();
-
-                while (!t.ready ())
-                    std::this_thread::yield ();
-
+                this->tasks_.pop ();
                 return std::make_pair (true, std::move (t));
             }
 
@@ -552,9 +828,7 @@ namespace dsa
             {
                 {
                     std::unique_lock <std::mutex> lock (this->mutex_);
-                    this->last_ = this->tasks_.emplace_after (
-                        this->last_, std::move (t)
-                    );
+                    this->tasks_.emplace (std::move (t));
                 }
                 this->cv_.notify_one ();
             }
@@ -567,6 +841,68 @@ namespace dsa
         std::size_t nthreads_;
         std::size_t current_index_ {0};
 
+        /*
+         * tasks whose future dependencies have not all been fulfilled;
+         * whenever a worker completes a task it sweeps this list and hands
+         * every task that became ready straight to a queue, so dependency
+         * completion drives scheduling instead of repeated readiness polls.
+         */
+        std::forward_list <awaitable_task> pending_;
+        std::mutex pending_mutex_;
+
+        /* places a ready task on some worker's queue */
+        void schedule_ (awaitable_task && t)
+        {
+            auto const idx = this->current_index_++;
+            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
+                if (this->queues_ [(idx + k) % this->nthreads_].try_push (t))
+                    return;
+
+            this->queues_ [idx % this->nthreads_].push (std::move (t));
+        }
+
+        /*
+         * moves every pending task whose dependencies are now fulfilled
+         * onto the ready queues; called by workers after each completion
+         * and before going idle (the latter catches futures fulfilled
+         * outside the system).
+         */
+        void resolve_pending_ (void)
+        {
+            std::forward_list <awaitable_task> ready;
+
+            {
+                std::unique_lock <std::mutex> lock (this->pending_mutex_);
+
+                auto prev = this->pending_.before_begin ();
+                auto it = this->pending_.begin ();
+
+                while (it != this->pending_.end ()) {
+                    if (it->ready ()) {
+                        ready.emplace_front (std::move (*it));
+                        it = this->pending_.erase_after (prev);
+                    } else {
+                        prev = it;
+                        ++it;
+                    }
+                }
+            }
+
+            for (auto & t : ready)
+                this->schedule_ (std::move (t));
+        }
+
+        /* routes a task by readiness: ready queues or the pending list */
+        void dispatch_ (awaitable_task && t)
+        {
+            if (t.ready ()) {
+                this->schedule_ (std::move (t));
+            } else {
+                std::unique_lock <std::mutex> lock (this->pending_mutex_);
+                this->pending_.emplace_front (std::move (t));
+            }
+        }
+
         void run (std::size_t id)
         {
             while (true) {
@@ -578,13 +914,33 @@ namespace dsa
                         break;
                 }
 
-                if (!p.first) {
+                if (p.first) {
+                    p.second ();
+                    this->resolve_pending_ ();
+                    continue;
+                }
+
+                this->resolve_pending_ ();
+
+                if (this->queues_ [id].done ()) {
+                    /*
+                     * drain the own queue before leaving; try_pop above may
+                     * have failed on lock contention rather than emptiness.
+                     * Pending tasks whose dependencies never complete are
+                     * abandoned at shutdown (their futures report
+                     * broken_promise).
+                     */
                     p = this->queues_ [id].pop ();
-                    if (!p.first)
-                        return;
+                    if (p.first) {
+                        p.second ();
+                        this->resolve_pending_ ();
+                        continue;
+                    }
+
+                    return;
                 }
 
-                p.second ();
+                this->queues_ [id].wait_for_work ();
             }
         }
 
@@ -638,14 +994,8 @@ namespace dsa
                 std::forward <F> (f), std::forward <Args> (args)...
             );
 
-            auto const idx = this->current_index_++;
-            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
-                if (this->queues_ [(idx + k) % this->nthreads_]
-                        .try_push (t.first))
-                    return t.second;
-
-            this->queues_ [idx % this->nthreads_].push (std::move (t.first));
-            return t.second;
+            this->schedule_ (std::move (t.first));
+            return std::move (t.second);
         }
 
         template <class F, class ... Args>
@@ -662,14 +1012,8 @@ namespace dsa
                 std::forward <F> (f), std::forward <Args> (args)...
             );
 
-            auto const idx = this->current_index_++;
-            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
-                if (this->queues_ [(idx + k) % this->nthreads_]
-                        .try_push (t.first))
-                    return t.second;
-
-            this->queues_ [idx % this->nthreads_].push (std::move (t.first));
-            return t.second;
+            this->dispatch_ (std::move (t.first));
+            return std::move (t.second);
         }
 
         template <class F, class ... Args>
@@ -685,12 +1029,7 @@ namespace dsa
 
         void push (awaitable_task && t)
         {
-            auto const idx = this->current_index_++;
-            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
-                if (this->queues_ [(idx + k) % this->nthreads_].try_push (t))
-                    return;
-
-            this->queues_ [idx % this->nthreads_].push (std::move (t));
+            this->dispatch_ (std::move (t));
         }
     };
 }   // namespace dsa
@@ -0,0 +1,140 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_bstree.cpp) is part of the dsa project.
+//
+// bstree insert/find/erase benchmarks across key distributions.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../bstree/bstree.hpp"
+#include "benchmark.hpp"
+
+
+namespace
+{
+    enum class distribution { sequential, uniform, clustered };
+
+    char const * name_of (distribution d)
+    {
+        switch (d) {
+            case distribution::sequential: return "sequential";
+            case distribution::uniform:    return "uniform";
+            default:                       return "clustered";
+        }
+    }
+
+    std::vector <std::int64_t> make_keys (distribution d, std::size_t n)
+    {
+        std::vector <std::int64_t> keys (n);
+        std::mt19937_64 gen (1);
+
+        switch (d) {
+            case distribution::sequential:
+                std::iota (keys.begin (), keys.end (), 0);
+                break;
+            case distribution::uniform: {
+                std::uniform_int_distribution <std::int64_t> dist;
+                for (auto & k : keys) { k = dist (gen); }
+                break;
+            }
+            case distribution::clustered: {
+                /* dense runs around sparse cluster origins */
+                std::uniform_int_distribution <std::int64_t>
+                    origin (0, 1l << 48);
+                std::int64_t base = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (i % 64 == 0) { base = origin (gen) << 8; }
+                    keys [i] = base + static_cast <std::int64_t> (i % 64);
+                }
+                std::shuffle (keys.begin (), keys.end (), gen);
+                break;
+            }
+        }
+
+        return keys;
+    }
+
+    void bench_distribution (distribution d, std::size_t n, std::size_t reps)
+    {
+        auto const keys = make_keys (d, n);
+
+        auto misses = keys;
+        for (auto & k : misses) { k = ~k; }
+
+        auto const tag = [&] (char const * op) {
+            return std::string ("bstree/") + op + "/" + name_of (d);
+        };
+
+        dsa::bench::report (dsa::bench::run (
+            tag ("insert"), reps, n, [&] {
+                dsa::bstree <std::int64_t> tree;
+                for (auto k : keys) { tree.insert (k); }
+                dsa::bench::do_not_optimize (tree);
+            }
+        ));
+
+        dsa::bstree <std::int64_t> tree;
+        for (auto k : keys) { tree.insert (k); }
+
+        dsa::bench::report (dsa::bench::run (
+            tag ("find-hit"), reps, n, [&] {
+                std::size_t found = 0;
+                for (auto k : keys) { found += tree.count (k); }
+                dsa::bench::do_not_optimize (found);
+            }
+        ));
+
+        dsa::bench::report (dsa::bench::run (
+            tag ("find-miss"), reps, n, [&] {
+                std::size_t found = 0;
+                for (auto k : misses) { found += tree.count (k); }
+                dsa::bench::do_not_optimize (found);
+            }
+        ));
+
+        dsa::bench::report (dsa::bench::run (
+            tag ("erase"), reps, n, [&] {
+                auto t = tree;
+                for (auto k : keys) { t.erase (k); }
+                dsa::bench::do_not_optimize (t);
+            }
+        ));
+    }
+}   // anonymous namespace
+
+int main (void)
+{
+    /* the key count is kept modest: bstree does not self-balance, so the
+     * sequential distribution degenerates to a linked list and costs
+     * O(n^2) per rep. */
+    dsa::bench::report_header ("bstree (10000 keys)");
+
+    for (auto d : {distribution::sequential, distribution::uniform,
+                   distribution::clustered})
+    {
+        bench_distribution (d, 10000, 5);
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_ringbuffer.cpp) is part of the dsa project.
+//
+// ringbuffer and dynamic_ringbuffer push/pop throughput benchmarks, plus
+// the concurrent buffers under producer/consumer load.
+//
+// the dynamic_ringbuffer and atomic_ringbuffer benchmarks live in their own
+// translation units (bench_ringbuffer_dynamic.cpp and
+// bench_ringbuffer_atomic.cpp) because each of those headers defines the
+// anonymous-namespace memblock helper and so cannot be included alongside
+// ringbuffer.hpp in a single translation unit.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ringbuffer/mpmc_ringbuffer.hpp"
+#include "../ringbuffer/ringbuffer.hpp"
+#include "benchmark.hpp"
+
+
+/* defined in bench_ringbuffer_dynamic.cpp and bench_ringbuffer_atomic.cpp */
+void bench_dynamic_ringbuffer (void);
+void bench_atomic_ringbuffer (void);
+
+namespace
+{
+    constexpr std::size_t ring_capacity = 1024;
+    constexpr std::size_t ops = 1 << 20;
+
+    void bench_ringbuffer (void)
+    {
+        dsa::ringbuffer <std::uint64_t, ring_capacity> rb;
+
+        dsa::bench::report (dsa::bench::run (
+            "ringbuffer/push-pop", 5, ops, [&] {
+                std::uint64_t sum = 0;
+                for (std::size_t i = 0; i < ops; i += ring_capacity) {
+                    for (std::size_t k = 0; k < ring_capacity; ++k) {
+                        rb.push (k);
+                    }
+                    while (!rb.empty ()) {
+                        sum += rb.front ();
+                        rb.pop ();
+                    }
+                }
+                dsa::bench::do_not_optimize (sum);
+            }
+        ));
+
+        std::vector <std::uint64_t> chunk (ring_capacity);
+        std::vector <std::uint64_t> out (ring_capacity);
+
+        dsa::bench::report (dsa::bench::run (
+            "ringbuffer/push_n-pop_n", 5, ops, [&] {
+                for (std::size_t i = 0; i < ops; i += ring_capacity) {
+                    rb.push_n (chunk.data (), chunk.size ());
+                    rb.pop_n (out.data (), out.size ());
+                }
+                dsa::bench::do_not_optimize (out);
+            }
+        ));
+    }
+
+    void bench_mpmc_ringbuffer (void)
+    {
+        dsa::mpmc_ringbuffer <std::uint64_t, ring_capacity> rb;
+
+        for (std::size_t producers : {1ul, 2ul}) {
+            dsa::bench::report (dsa::bench::run (
+                "mpmc_ringbuffer/" + std::to_string (producers) + "p" +
+                    std::to_string (producers) + "c",
+                5, ops, [&] {
+                    std::vector <std::thread> threads;
+                    auto const per_thread = ops / producers;
+
+                    for (std::size_t p = 0; p < producers; ++p) {
+                        threads.emplace_back ([&] {
+                            for (std::size_t i = 0; i < per_thread; ) {
+                                i += rb.push (i);
+                            }
+                        });
+                    }
+                    for (std::size_t c = 0; c < producers; ++c) {
+                        threads.emplace_back ([&] {
+                            std::uint64_t sum = 0;
+                            std::uint64_t v;
+                            for (std::size_t i = 0; i < per_thread; ) {
+                                if (rb.pop (v)) {
+                                    sum += v;
+                                    i += 1;
+                                }
+                            }
+                            dsa::bench::do_not_optimize (sum);
+                        });
+                    }
+
+                    for (auto & t : threads) { t.join (); }
+                }
+            ));
+        }
+    }
+}   // anonymous namespace
+
+int main (void)
+{
+    dsa::bench::report_header ("ringbuffers (1048576 operations per rep)");
+
+    bench_ringbuffer ();
+    bench_dynamic_ringbuffer ();
+    bench_atomic_ringbuffer ();
+    bench_mpmc_ringbuffer ();
+
+    return 0;
+}
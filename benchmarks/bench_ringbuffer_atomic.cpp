@@ -0,0 +1,63 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_ringbuffer_atomic.cpp) is part of the dsa project.
+//
+// atomic_ringbuffer single-producer/single-consumer benchmark; a separate
+// translation unit from bench_ringbuffer.cpp because atomic_ringbuffer.hpp
+// and ringbuffer.hpp each define the anonymous-namespace memblock helper.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <cstdint>
+#include <thread>
+
+#include "../ringbuffer/atomic_ringbuffer.hpp"
+#include "benchmark.hpp"
+
+
+namespace
+{
+    constexpr std::size_t ring_capacity = 1024;
+    constexpr std::size_t ops = 1 << 20;
+}   // anonymous namespace
+
+void bench_atomic_ringbuffer (void)
+{
+    dsa::atomic_ringbuffer <std::uint64_t, ring_capacity> rb;
+
+    dsa::bench::report (dsa::bench::run (
+        "atomic_ringbuffer/spsc", 5, ops, [&] {
+            std::thread producer ([&] {
+                for (std::size_t i = 0; i < ops; ) {
+                    i += rb.push (i);
+                }
+            });
+
+            std::uint64_t sum = 0;
+            std::uint64_t v;
+            for (std::size_t i = 0; i < ops; ) {
+                if (rb.pop (v)) {
+                    sum += v;
+                    i += 1;
+                }
+            }
+
+            producer.join ();
+            dsa::bench::do_not_optimize (sum);
+        }
+    ));
+}
@@ -0,0 +1,56 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_ringbuffer_dynamic.cpp) is part of the dsa project.
+//
+// dynamic_ringbuffer throughput benchmark; a separate translation unit from
+// bench_ringbuffer.cpp because dynamic_ringbuffer.hpp and ringbuffer.hpp
+// each define the anonymous-namespace memblock helper.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <cstdint>
+
+#include "../dynamic_ringbuffer/dynamic_ringbuffer.hpp"
+#include "benchmark.hpp"
+
+
+namespace
+{
+    constexpr std::size_t ring_capacity = 1024;
+    constexpr std::size_t ops = 1 << 20;
+}   // anonymous namespace
+
+void bench_dynamic_ringbuffer (void)
+{
+    dsa::dynamic_ringbuffer <std::uint64_t> rb;
+
+    dsa::bench::report (dsa::bench::run (
+        "dynamic_ringbuffer/push-pop", 5, ops, [&] {
+            std::uint64_t sum = 0;
+            for (std::size_t i = 0; i < ops; i += ring_capacity) {
+                for (std::size_t k = 0; k < ring_capacity; ++k) {
+                    rb.push (k);
+                }
+                while (!rb.empty ()) {
+                    sum += rb.front ();
+                    rb.pop ();
+                }
+            }
+            dsa::bench::do_not_optimize (sum);
+        }
+    ));
+}
@@ -0,0 +1,136 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_sorting.cpp) is part of the dsa project.
+//
+// blocksort/shellsort/radixsort benchmarks against std::sort across input
+// sizes and entropy levels.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../sorting/blocksort.hpp"
+#include "../sorting/radixsort.hpp"
+#include "../sorting/shellsort.hpp"
+#include "benchmark.hpp"
+
+
+namespace
+{
+    enum class entropy { random, sorted, reversed, few_uniques };
+
+    char const * name_of (entropy e)
+    {
+        switch (e) {
+            case entropy::random:   return "random";
+            case entropy::sorted:   return "sorted";
+            case entropy::reversed: return "reversed";
+            default:                return "few-uniques";
+        }
+    }
+
+    std::vector <std::uint64_t> make_input (entropy e, std::size_t n)
+    {
+        std::mt19937_64 gen (2);
+        std::vector <std::uint64_t> v (n);
+
+        switch (e) {
+            case entropy::random: {
+                std::uniform_int_distribution <std::uint64_t> dist;
+                for (auto & x : v) { x = dist (gen); }
+                break;
+            }
+            case entropy::sorted:
+                for (std::size_t i = 0; i < n; ++i) { v [i] = i; }
+                break;
+            case entropy::reversed:
+                for (std::size_t i = 0; i < n; ++i) { v [i] = n - i; }
+                break;
+            case entropy::few_uniques: {
+                std::uniform_int_distribution <std::uint64_t> dist (0, 15);
+                for (auto & x : v) { x = dist (gen); }
+                break;
+            }
+        }
+
+        return v;
+    }
+
+    template <typename Sort>
+    void bench_sort (std::string const & name, entropy e, std::size_t n,
+                     Sort sort)
+    {
+        auto const input = make_input (e, n);
+
+        dsa::bench::report (dsa::bench::run (
+            name + "/" + name_of (e) + "/" + std::to_string (n), 5, n,
+            [&] {
+                auto v = input;
+                sort (v);
+                dsa::bench::do_not_optimize (v);
+            }
+        ));
+    }
+
+    void bench_entropy (entropy e, std::size_t n)
+    {
+        bench_sort ("std::sort", e, n, [] (std::vector <std::uint64_t> & v) {
+            std::sort (v.begin (), v.end ());
+        });
+
+        bench_sort ("blocksort", e, n, [] (std::vector <std::uint64_t> & v) {
+            dsa::blocksort (v.begin (), v.end ());
+        });
+
+        std::vector <std::uint64_t> scratch (n / 2 + 1);
+        bench_sort (
+            "blocksort-scratch", e, n,
+            [&scratch] (std::vector <std::uint64_t> & v) {
+                dsa::blocksort (
+                    v.begin (), v.end (), scratch.data (), scratch.size ()
+                );
+            }
+        );
+
+        bench_sort ("shellsort", e, n, [] (std::vector <std::uint64_t> & v) {
+            dsa::shellsort (v.begin (), v.end ());
+        });
+
+        bench_sort ("radixsort", e, n, [] (std::vector <std::uint64_t> & v) {
+            dsa::radixsort (v.begin (), v.end ());
+        });
+    }
+}   // anonymous namespace
+
+int main (void)
+{
+    dsa::bench::report_header ("sorting (ns per element)");
+
+    for (std::size_t n : {1ul << 12, 1ul << 16, 1ul << 20}) {
+        for (auto e : {entropy::random, entropy::sorted, entropy::reversed,
+                       entropy::few_uniques})
+        {
+            bench_entropy (e, n);
+        }
+    }
+
+    return 0;
+}
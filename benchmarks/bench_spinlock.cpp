@@ -0,0 +1,118 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_spinlock.cpp) is part of the dsa project.
+//
+// spinlock benchmarks under varied contention, against std::mutex.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../spinlock/spinlock.hpp"
+#include "benchmark.hpp"
+
+
+namespace
+{
+    constexpr std::size_t total_ops = 1 << 18;
+
+    template <typename Lock>
+    void bench_lock (std::string const & name, std::size_t nthreads)
+    {
+        Lock lk;
+        long counter = 0;
+
+        dsa::bench::report (dsa::bench::run (
+            name + "/threads=" + std::to_string (nthreads), 5, total_ops,
+            [&] {
+                auto const per_thread = total_ops / nthreads;
+
+                std::vector <std::thread> threads;
+                for (std::size_t t = 0; t < nthreads; ++t) {
+                    threads.emplace_back ([&] {
+                        for (std::size_t i = 0; i < per_thread; ++i) {
+                            std::lock_guard <Lock> guard (lk);
+                            counter += 1;
+                        }
+                    });
+                }
+
+                for (auto & th : threads) { th.join (); }
+                dsa::bench::do_not_optimize (counter);
+            }
+        ));
+    }
+
+    void bench_contention (std::size_t nthreads)
+    {
+        using wait_spinlock = dsa::spinlock <std::chrono::nanoseconds, 320>;
+
+        bench_lock <std::mutex> ("std::mutex", nthreads);
+        bench_lock <wait_spinlock> ("spinlock", nthreads);
+        bench_lock <dsa::backoff_spinlock> ("backoff_spinlock", nthreads);
+        bench_lock <dsa::ticket_spinlock> ("ticket_spinlock", nthreads);
+        bench_lock <dsa::shared_spinlock <>> ("shared_spinlock", nthreads);
+    }
+
+    void bench_shared_readers (std::size_t nreaders)
+    {
+        dsa::shared_spinlock <> lk;
+        long value = 42;
+
+        dsa::bench::report (dsa::bench::run (
+            "shared_spinlock/readers=" + std::to_string (nreaders), 5,
+            total_ops,
+            [&] {
+                auto const per_thread = total_ops / nreaders;
+
+                std::vector <std::thread> threads;
+                for (std::size_t t = 0; t < nreaders; ++t) {
+                    threads.emplace_back ([&] {
+                        long sum = 0;
+                        for (std::size_t i = 0; i < per_thread; ++i) {
+                            lk.lock_shared ();
+                            sum += value;
+                            lk.unlock_shared ();
+                        }
+                        dsa::bench::do_not_optimize (sum);
+                    });
+                }
+
+                for (auto & th : threads) { th.join (); }
+            }
+        ));
+    }
+}   // anonymous namespace
+
+int main (void)
+{
+    dsa::bench::report_header ("spinlocks (262144 lock/unlock pairs per rep)");
+
+    for (std::size_t nthreads : {1ul, 2ul, 4ul, 8ul}) {
+        bench_contention (nthreads);
+    }
+
+    for (std::size_t nreaders : {1ul, 2ul, 4ul, 8ul}) {
+        bench_shared_readers (nreaders);
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (bench_task_system.cpp) is part of the dsa project.
+//
+// task_system submission latency and throughput benchmarks over worker
+// counts.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../task/task.hpp"
+#include "benchmark.hpp"
+
+
+namespace
+{
+    constexpr std::size_t ntasks = 1 << 14;
+
+    /* round-trip latency: submit one task and wait for its future */
+    void bench_latency (std::size_t nthreads)
+    {
+        dsa::task_system <> ts (nthreads);
+
+        dsa::bench::report (dsa::bench::run (
+            "task_system/latency/threads=" + std::to_string (nthreads),
+            5, 256,
+            [&] {
+                for (std::size_t i = 0; i < 256; ++i) {
+                    ts.push ([] { return 1; }).get ();
+                }
+            }
+        ));
+    }
+
+    /* throughput: a burst of no-op tasks, joined by a counter */
+    void bench_throughput (std::size_t nthreads)
+    {
+        dsa::task_system <> ts (nthreads);
+
+        dsa::bench::report (dsa::bench::run (
+            "task_system/throughput/threads=" + std::to_string (nthreads),
+            5, ntasks,
+            [&] {
+                std::atomic <std::size_t> done {0};
+
+                for (std::size_t i = 0; i < ntasks; ++i) {
+                    ts.push (dsa::make_detached_task (
+                        [&done] { done.fetch_add (1); }
+                    ));
+                }
+
+                while (done.load () != ntasks) {
+                    std::this_thread::yield ();
+                }
+            }
+        ));
+    }
+
+    /* bulk submission through push_bulk versus one push per task */
+    void bench_bulk (std::size_t nthreads)
+    {
+        dsa::task_system <> ts (nthreads);
+
+        dsa::bench::report (dsa::bench::run (
+            "task_system/push_bulk/threads=" + std::to_string (nthreads),
+            5, ntasks,
+            [&] {
+                std::atomic <std::size_t> done {0};
+
+                ts.push_bulk (ntasks, [&done] {
+                    return dsa::make_detached_task (
+                        [&done] { done.fetch_add (1); }
+                    );
+                });
+
+                while (done.load () != ntasks) {
+                    std::this_thread::yield ();
+                }
+            }
+        ));
+    }
+
+    /* fork/join scaling: a binary tree of tasks spawned from workers */
+    void fork_count (dsa::task_system <> & ts,
+                     std::atomic <std::size_t> & count,
+                     int depth)
+    {
+        count.fetch_add (1);
+        if (depth > 0) {
+            for (int i = 0; i < 2; ++i) {
+                ts.push (dsa::make_detached_task (
+                    [&ts, &count, depth] {
+                        fork_count (ts, count, depth - 1);
+                    }
+                ));
+            }
+        }
+    }
+
+    void bench_fork_join (std::size_t nthreads)
+    {
+        dsa::task_system <> ts (nthreads);
+        constexpr int depth = 12;
+        constexpr std::size_t nodes = (1ul << (depth + 1)) - 1;
+
+        dsa::bench::report (dsa::bench::run (
+            "task_system/fork-join/threads=" + std::to_string (nthreads),
+            5, nodes,
+            [&] {
+                std::atomic <std::size_t> count {0};
+                ts.push (dsa::make_detached_task (
+                    [&ts, &count] { fork_count (ts, count, depth); }
+                ));
+
+                while (count.load () != nodes) {
+                    std::this_thread::yield ();
+                }
+            }
+        ));
+    }
+}   // anonymous namespace
+
+int main (void)
+{
+    dsa::bench::report_header ("task_system (ns per task)");
+
+    for (std::size_t nthreads : {1ul, 2ul, 4ul, 8ul}) {
+        bench_latency (nthreads);
+        bench_throughput (nthreads);
+        bench_bulk (nthreads);
+        bench_fork_join (nthreads);
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (benchmark.hpp) is part of the dsa project.
+//
+// benchmark; a minimal timing harness for the dsa microbenchmark suite.
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_BENCHMARKS_BENCHMARK_HPP
+#define DSA_BENCHMARKS_BENCHMARK_HPP
+
+#include <algorithm>    // std::min_element
+#include <chrono>       // std::chrono::steady_clock
+#include <cmath>        // std::sqrt
+#include <cstdio>       // std::printf
+#include <cstddef>      // std::size_t
+#include <string>       // std::string
+#include <utility>      // std::forward
+#include <vector>       // std::vector
+
+
+namespace dsa
+{
+namespace bench
+{
+    /*
+     * forces the compiler to assume the value (and anything reachable from
+     * it) is read, so computations feeding it cannot be optimized away.
+     */
+    template <typename T>
+    inline void do_not_optimize (T const & value)
+    {
+        asm volatile ("" : : "g" (&value) : "memory");
+    }
+
+    /* forces preceding stores to be considered observed */
+    inline void clobber_memory (void)
+    {
+        asm volatile ("" : : : "memory");
+    }
+
+    /*
+     * the timing summary of one benchmark: per-item wall clock statistics
+     * over the repetitions, where a repetition executes the benchmark body
+     * once and a body covers items_per_rep individual operations.
+     */
+    struct result
+    {
+        std::string name;
+        std::size_t repetitions;
+        std::size_t items_per_rep;
+        double mean_ns;
+        double stddev_ns;
+        double min_ns;
+    };
+
+    /*
+     * times repetitions of body (), after one untimed warmup run, and
+     * reduces the samples to per-item mean, sample standard deviation, and
+     * minimum in nanoseconds.
+     */
+    template <typename F>
+    result run (std::string name, std::size_t repetitions,
+                std::size_t items_per_rep, F && body)
+    {
+        using clock = std::chrono::steady_clock;
+
+        body ();
+
+        std::vector <double> samples;
+        samples.reserve (repetitions);
+
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            auto const start = clock::now ();
+            body ();
+            auto const stop = clock::now ();
+
+            samples.push_back (
+                static_cast <double> (
+                    std::chrono::duration_cast <std::chrono::nanoseconds> (
+                        stop - start
+                    ).count ()
+                ) / static_cast <double> (items_per_rep)
+            );
+        }
+
+        double sum = 0.0;
+        for (auto s : samples) { sum += s; }
+        auto const mean = sum / static_cast <double> (samples.size ());
+
+        double var = 0.0;
+        for (auto s : samples) { var += (s - mean) * (s - mean); }
+        var = samples.size () > 1
+            ? var / static_cast <double> (samples.size () - 1)
+            : 0.0;
+
+        return result {
+            std::move (name), repetitions, items_per_rep,
+            mean, std::sqrt (var),
+            *std::min_element (samples.begin (), samples.end ())
+        };
+    }
+
+    inline void report_header (char const * title)
+    {
+        std::printf ("%s\n", title);
+        std::printf (
+            "%-48s %12s %12s %12s\n",
+            "benchmark", "mean", "stddev", "min"
+        );
+        std::printf (
+            "%-48s %12s %12s %12s\n",
+            "", "(ns/op)", "(ns/op)", "(ns/op)"
+        );
+    }
+
+    inline void report (result const & r)
+    {
+        std::printf (
+            "%-48s %12.2f %12.2f %12.2f\n",
+            r.name.c_str (), r.mean_ns, r.stddev_ns, r.min_ns
+        );
+    }
+}   // namespace bench
+}   // namespace dsa
+
+#endif  // #ifndef DSA_BENCHMARKS_BENCHMARK_HPP
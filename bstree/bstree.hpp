@@ -30,17 +30,24 @@
 
 #include <algorithm>        // std::equal, std::lexicographical_compare,
                             // std::max
+#include <atomic>           // std::atomic
 #include <cassert>          // assert
 #include <cstddef>          // std::ptrdiff_t, std::size_t
+#include <cstdint>          // std::uint64_t
+#include <cstring>          // std::memcpy
 #include <exception>        // std::current_exception, std::exception_ptr,
                             // std::rethrow_exception
 #include <functional>       // std::function, std::less
 #include <initializer_list> // std::initializer_list
+#include <iterator>         // std::distance
+#include <limits>           // std::numeric_limits
 #include <tuple>            // std::tuple
 #include <type_traits>      // 
 #include <memory>           // std::allocator, std::allocator_traits,
                             // std::unique_ptr
+#include <stdexcept>        // std::runtime_error
 #include <utility>          // std::pair
+#include <vector>           // std::vector
 
 
 namespace dsa
@@ -51,6 +58,28 @@ namespace detail
     struct mutable_tag {};
     struct const_tag {};
 
+    template <class...>
+    struct voider
+    {
+        using type = void;
+    };
+
+    /*
+     * detects the nested is_transparent typedef that opts a comparator
+     * into heterogeneous lookup; only its presence matters (for
+     * std::less <void> it is an alias for void), so testing
+     * Compare::is_transparent::value directly would wrongly reject
+     * standard transparent comparators.
+     */
+    template <class Compare, class = void>
+    struct is_transparent : std::false_type {};
+
+    template <class Compare>
+    struct is_transparent <
+        Compare,
+        typename voider <typename Compare::is_transparent>::type
+    > : std::true_type {};
+
     template <class Node, class Value, class Tag>
     struct bstree_iterator
     {
@@ -112,7 +141,7 @@ namespace detail
         bstree_iterator (bstree_iterator <Node, Value, OTag> const & other)
             noexcept
             : _iter  {other._iter}
-            , _state {other._state}
+            , _state {static_cast <enum state> (other._state)}
         {}
 
         template <
@@ -128,7 +157,8 @@ namespace detail
             noexcept
         {
             this->_iter = other._iter;
-            this->_state = other._state;
+            this->_state = static_cast <enum state> (other._state);
+            return *this;
         }
 
         void swap (bstree_iterator & other) noexcept
@@ -245,17 +275,21 @@ namespace detail
                                 // so we're in an invalid state
                                 if (!it->parent) {
                                     this->_state = state::invalid;
-                                    this->_iter = nullptr;
+                                    n = nullptr;
+                                    break;
                                 // otherwise check if we move up from the
                                 // right, and in this case we're done
                                 } else if (it->parent->right == it) {
                                     n = it->parent;
+                                    break;
                                 // otherwise continue upwards
                                 } else {
                                     it = it->parent;
                                     continue;
                                 }
                             }
+
+                            this->_iter = n;
                         }
                     // if we are the root then we're in an invalid state
                     } else {
@@ -302,15 +336,804 @@ namespace detail
             return !(*this == other);
         }
     };
+    /*
+     * per-node storage for the augment policies; bstree::node inherits from
+     * the base selected by its AugmentPolicy, so unaugmented trees pay no
+     * per-node memory cost.
+     */
+    struct no_augment_base
+    {
+        void assign (no_augment_base const &) noexcept {}
+        void clear (void) noexcept {}
+    };
+
+    struct subtree_size_base
+    {
+        std::size_t subtree_size = 1;
+
+        void assign (subtree_size_base const & other) noexcept
+        {
+            this->subtree_size = other.subtree_size;
+        }
+
+        void clear (void) noexcept
+        {
+            this->subtree_size = 1;
+        }
+    };
+
+    /*
+     * on-disk image format for bstree serialization; see bstree::serialize
+     * and dsa::bstree_view. All offsets are node indices into the record
+     * array following the header, with bstree_image_npos marking absent
+     * links. Records are laid out in in-order (sorted) sequence, so the
+     * image doubles as a sorted array; the left/right links preserve the
+     * exact shape of the serialized tree. Images are written in the native
+     * byte order and are intended for mapping on the architecture that
+     * produced them.
+     */
+    constexpr std::uint64_t bstree_image_magic   = 0x007473622e617364; // "dsa.bst"
+    constexpr std::uint64_t bstree_image_version = 1;
+    constexpr std::uint64_t bstree_image_npos    = UINT64_MAX;
+
+    struct bstree_image_header
+    {
+        std::uint64_t magic;
+        std::uint64_t version;
+        std::uint64_t count;
+        std::uint64_t root;
+        std::uint64_t reserved [4];
+    };
+
+    static_assert (
+        sizeof (bstree_image_header) == 64,
+        "bstree image headers are exactly one cache line"
+    );
+
+    template <class Key>
+    struct bstree_image_node
+    {
+        std::uint64_t left;
+        std::uint64_t right;
+        Key value;
+    };
+
+    /*
+     * acquire/release accesses to the raw link pointers of tree nodes,
+     * used by the bstree concurrent read mode. the links remain plain
+     * pointers so that the single threaded paths are untouched; the
+     * writer publishes link stores with release ordering and readers
+     * traverse with acquire loads.
+     */
+    template <class T>
+    inline T * link_load_acquire (T * const * link) noexcept
+    {
+#if defined (__GNUC__) || defined (__clang__)
+        return __atomic_load_n (link, __ATOMIC_ACQUIRE);
+#else
+        auto const n = *static_cast <T * const volatile *> (link);
+        std::atomic_thread_fence (std::memory_order_acquire);
+        return n;
+#endif
+    }
+
+    template <class T>
+    inline void link_store_release (T ** link, T * n) noexcept
+    {
+#if defined (__GNUC__) || defined (__clang__)
+        __atomic_store_n (link, n, __ATOMIC_RELEASE);
+#else
+        std::atomic_thread_fence (std::memory_order_release);
+        *static_cast <T * volatile *> (link) = n;
+#endif
+    }
+
+    /*
+     * epoch registry backing the bstree concurrent read mode. the single
+     * writer thread advances the global epoch each time it retires an
+     * erased node; reader threads pin the epoch that is current when
+     * their traversal begins. a retired node may be reclaimed once every
+     * active reader has pinned an epoch later than the retirement epoch,
+     * at which point no traversal can still hold a pointer into it.
+     *
+     * reader slots are kept in a lock free singly linked list so that
+     * claiming a previously released slot never blocks; a new slot is
+     * allocated only the first time the number of simultaneous readers
+     * exceeds the high water mark.
+     */
+    class epoch_registry
+    {
+    public:
+        struct reader_slot
+        {
+            /* 0 marks the slot as inactive; an active reader stores its
+             * (nonzero) pinned epoch. */
+            std::atomic <std::size_t> epoch {0};
+            std::atomic <bool> claimed {false};
+        };
+
+        epoch_registry (void) = default;
+
+        epoch_registry (epoch_registry const &) = delete;
+        epoch_registry & operator= (epoch_registry const &) = delete;
+
+        ~epoch_registry (void)
+        {
+            auto n = this->_slots.load (std::memory_order_acquire);
+            while (n) {
+                auto const next = n->next;
+                delete n;
+                n = next;
+            }
+        }
+
+        reader_slot * claim_slot (void)
+        {
+            for (auto n = this->_slots.load (std::memory_order_acquire);
+                 n != nullptr; n = n->next)
+            {
+                auto expected = false;
+                if (n->slot.claimed.compare_exchange_strong (
+                        expected, true, std::memory_order_acq_rel
+                    ))
+                {
+                    return &n->slot;
+                }
+            }
+
+            auto const fresh = new slot_node {};
+            fresh->slot.claimed.store (true, std::memory_order_relaxed);
+
+            auto head = this->_slots.load (std::memory_order_relaxed);
+            do {
+                fresh->next = head;
+            } while (!this->_slots.compare_exchange_weak (
+                head, fresh,
+                std::memory_order_release, std::memory_order_relaxed
+            ));
+
+            return &fresh->slot;
+        }
+
+        void release_slot (reader_slot * slot) noexcept
+        {
+            slot->epoch.store (0, std::memory_order_release);
+            slot->claimed.store (false, std::memory_order_release);
+        }
+
+        /*
+         * pins the current epoch in slot. the store/reload loop closes
+         * the race with a concurrently advancing writer: once the reload
+         * observes the epoch that was stored, the sequentially consistent
+         * ordering of the store against the writer's advance guarantees
+         * that either the writer observes the pin when it next scans the
+         * slots, or the pin is of a later epoch than anything the writer
+         * has retired so far.
+         */
+        void pin (reader_slot * slot) noexcept
+        {
+            auto e = this->_epoch.load ();
+            while (true) {
+                slot->epoch.store (e, std::memory_order_seq_cst);
+                auto const latest = this->_epoch.load ();
+                if (latest == e) {
+                    break;
+                }
+                e = latest;
+            }
+        }
+
+        /* writer side: tags a retirement and advances the global epoch */
+        std::size_t retire_epoch (void) noexcept
+        {
+            return this->_epoch.fetch_add (1);
+        }
+
+        /*
+         * writer side: the earliest epoch still pinned by an active
+         * reader; retirements tagged with a strictly earlier epoch are
+         * unreachable by every current and future traversal.
+         */
+        std::size_t horizon (void) const noexcept
+        {
+            auto min = this->_epoch.load ();
+
+            for (auto n = this->_slots.load (std::memory_order_acquire);
+                 n != nullptr; n = n->next)
+            {
+                auto const e = n->slot.epoch.load ();
+                if (e != 0 && e < min) {
+                    min = e;
+                }
+            }
+
+            return min;
+        }
+
+    private:
+        struct slot_node
+        {
+            reader_slot slot;
+            slot_node * next;
+        };
+
+        std::atomic <std::size_t> _epoch {1};
+        std::atomic <slot_node *> _slots {nullptr};
+    };
 }   // namespace detail
 
+    /*
+     * balancing policies for bstree, selected at compile time via the
+     * BalancePolicy template parameter:
+     *
+     *      - balance::none: the tree shape is determined entirely by
+     *        insertion and erasure order; this is the historical behavior
+     *        and the fastest option for random insertion orders.
+     *
+     *      - balance::avl: the tree is rebalanced with AVL rotations along
+     *        the insert and erase paths, guaranteeing O(log n) height
+     *        regardless of insertion order (e.g., for sorted ingest streams
+     *        that would otherwise degenerate the tree into a list).
+     */
+    namespace balance
+    {
+        struct none {};
+        struct avl {};
+    }   // namespace balance
+
+    /*
+     * order-statistics policies for bstree, selected at compile time via
+     * the AugmentPolicy template parameter:
+     *
+     *      - augment::none: no augmentation; this is the historical
+     *        behavior and carries no per-node memory cost.
+     *
+     *      - augment::subtree_size: each node additionally records the size
+     *        of its subtree, maintained along the same paths that maintain
+     *        node heights; this enables the O(log n) select () and rank ()
+     *        member functions.
+     */
+    namespace augment
+    {
+        struct none {};
+        struct subtree_size {};
+    }   // namespace augment
+
+    /*
+     * tag type selecting the O(n) bulk-load constructor overload for input
+     * ranges that are already sorted (with respect to the tree's comparator)
+     * and free of duplicate keys.
+     */
+    struct sorted_unique_t {};
+    constexpr sorted_unique_t sorted_unique {};
+
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::bstree_snapshot <> is an immutable, pointer-free flattening of a
+     * set of unique keys for read-heavy phases. Keys are stored in a single
+     * contiguous array in breadth-first (Eytzinger) order of the implicit
+     * perfectly balanced search tree, indexed arithmetically: the children
+     * of slot k are slots 2k + 1 and 2k + 2. Lookups therefore perform the
+     * usual O(log n) comparisons but touch a handful of cache lines near
+     * the front of the array for the first levels of every search, rather
+     * than chasing pointers between individually allocated nodes.
+     *
+     * A snapshot is a value type detached from the tree it was frozen from:
+     * it never mutates after construction, so it can be shared across
+     * reader threads without synchronization, and it remains valid after
+     * the source tree is modified or destroyed.
+     *
+     * Snapshots are created with bstree::freeze (), or directly from any
+     * sorted range of unique keys.
+     *
+     * Template Parameters
+     * -------------------
+     * - Key: the key type held in the snapshot.
+     *
+     * - Compare: the strict weak ordering over Key; shared with the source
+     *   bstree when created via freeze ().
+     *
+     * Member Functions
+     * ----------------
+     * Lookups return pointers into the snapshot's own storage, or nullptr
+     * when no matching element exists.
+     *
+     *      - size/empty
+     *      - find/count/contains
+     *      - lower_bound/upper_bound
+     *      - key_comp
+     */
+    template <class Key, class Compare = std::less <Key>>
+    class bstree_snapshot
+    {
+    public:
+        using value_type      = Key;
+        using key_compare     = Compare;
+        using size_type       = std::size_t;
+        using const_pointer   = value_type const *;
+        using const_reference = value_type const &;
+
+        bstree_snapshot (void)
+            : _flat     {}
+            , _key_comp {}
+        {}
+
+        /*
+         * Builds a snapshot from [first, last), which must be sorted with
+         * respect to comp and must not contain duplicate keys.
+         */
+        template <class ForwardIt>
+        bstree_snapshot (ForwardIt first,
+                         ForwardIt last,
+                         Compare comp = Compare ())
+            : _flat     {}
+            , _key_comp {comp}
+        {
+            std::vector <value_type> sorted (first, last);
+
+            /*
+             * compute, for each breadth-first slot, the in-order rank of
+             * the element it holds; an in-order walk of the implicit tree
+             * visits the slots in sorted order.
+             */
+            std::vector <size_type> rank (sorted.size ());
+            {
+                size_type next = 0;
+                inorder_ranks (rank, 0, next);
+            }
+
+            this->_flat.reserve (sorted.size ());
+            for (auto r : rank) {
+                this->_flat.push_back (std::move (sorted [r]));
+            }
+        }
+
+        ~bstree_snapshot (void) = default;
+
+        bstree_snapshot (bstree_snapshot const &) = default;
+        bstree_snapshot (bstree_snapshot &&) = default;
+        bstree_snapshot & operator= (bstree_snapshot const &) = default;
+        bstree_snapshot & operator= (bstree_snapshot &&) = default;
+
+        size_type size (void) const noexcept
+        {
+            return this->_flat.size ();
+        }
+
+        bool empty (void) const noexcept
+        {
+            return this->_flat.empty ();
+        }
+
+        key_compare key_comp (void) const
+        {
+            return this->_key_comp;
+        }
+
+        const_pointer lower_bound (value_type const & key) const
+        {
+            auto const n = this->_flat.size ();
+            auto const data = this->_flat.data ();
+
+            size_type k = 0;
+            auto best = n;
+
+            while (k < n) {
+                if (this->_key_comp (data [k], key)) {
+                    k = 2 * k + 2;
+                } else {
+                    best = k;
+                    k = 2 * k + 1;
+                }
+            }
+
+            return best == n ? nullptr : data + best;
+        }
+
+        const_pointer upper_bound (value_type const & key) const
+        {
+            auto const n = this->_flat.size ();
+            auto const data = this->_flat.data ();
+
+            size_type k = 0;
+            auto best = n;
+
+            while (k < n) {
+                if (this->_key_comp (key, data [k])) {
+                    best = k;
+                    k = 2 * k + 1;
+                } else {
+                    k = 2 * k + 2;
+                }
+            }
+
+            return best == n ? nullptr : data + best;
+        }
+
+        const_pointer find (value_type const & key) const
+        {
+            auto const lb = this->lower_bound (key);
+
+            if (lb && !this->_key_comp (key, *lb)) {
+                return lb;
+            } else {
+                return nullptr;
+            }
+        }
+
+        size_type count (value_type const & key) const
+        {
+            return this->find (key) ? 1 : 0;
+        }
+
+        bool contains (value_type const & key) const
+        {
+            return this->find (key) != nullptr;
+        }
+
+    private:
+        void inorder_ranks (std::vector <size_type> & rank,
+                            size_type k,
+                            size_type & next) const
+        {
+            if (k >= rank.size ()) {
+                return;
+            }
+
+            inorder_ranks (rank, 2 * k + 1, next);
+            rank [k] = next++;
+            inorder_ranks (rank, 2 * k + 2, next);
+        }
+
+        std::vector <value_type> _flat;
+        key_compare              _key_comp;
+    };
+
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::bstree_view <> is a read-only search-tree interface over a
+     * serialized bstree image produced by bstree::serialize (), typically
+     * obtained by memory-mapping the file the image was written to. The
+     * view performs no allocation and never copies or modifies the image;
+     * constructing one is a validation pass over the 64-byte header, so
+     * loading a persisted index is an mmap call rather than a rebuild.
+     *
+     * Records in the image are laid out in sorted (in-order) sequence, so
+     * iteration is a linear scan; find () and the bound queries descend the
+     * serialized left/right links, preserving the shape of the source tree.
+     *
+     * The image must have been produced on an architecture with the same
+     * byte order and Key representation. The view does not own the mapping;
+     * the caller must keep it alive for the lifetime of the view.
+     *
+     * Template Parameters
+     * ----------------
+     * - Key: the key type of the serialized tree; must be trivially
+     *   copyable (enforced at compile time).
+     *
+     * - Compare: the strict weak ordering the source tree was built with.
+     */
+    template <class Key, class Compare = std::less <Key>>
+    class bstree_view
+    {
+        static_assert (
+            std::is_trivially_copyable <Key>::value,
+            "bstree images hold raw object representations, so keys must be "
+            "trivially copyable"
+        );
+
+        using image_node = detail::bstree_image_node <Key>;
+
+    public:
+        using value_type      = Key;
+        using key_compare     = Compare;
+        using size_type       = std::size_t;
+        using const_reference = value_type const &;
+        using const_pointer   = value_type const *;
+
+        class const_iterator
+        {
+        public:
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = Key;
+            using pointer           = value_type const *;
+            using reference         = value_type const &;
+            using iterator_category = std::random_access_iterator_tag;
+
+            const_iterator (void) noexcept
+                : _pos {nullptr}
+            {}
+
+            explicit const_iterator (image_node const * pos) noexcept
+                : _pos {pos}
+            {}
+
+            reference operator* (void) const noexcept
+            {
+                return this->_pos->value;
+            }
+
+            pointer operator-> (void) const noexcept
+            {
+                return &this->_pos->value;
+            }
+
+            reference operator[] (difference_type n) const noexcept
+            {
+                return this->_pos [n].value;
+            }
+
+            const_iterator & operator++ (void) noexcept
+            {
+                ++this->_pos;
+                return *this;
+            }
+
+            const_iterator operator++ (int) noexcept
+            {
+                auto tmp = *this;
+                ++this->_pos;
+                return tmp;
+            }
+
+            const_iterator & operator-- (void) noexcept
+            {
+                --this->_pos;
+                return *this;
+            }
+
+            const_iterator operator-- (int) noexcept
+            {
+                auto tmp = *this;
+                --this->_pos;
+                return tmp;
+            }
+
+            const_iterator & operator+= (difference_type n) noexcept
+            {
+                this->_pos += n;
+                return *this;
+            }
+
+            const_iterator & operator-= (difference_type n) noexcept
+            {
+                this->_pos -= n;
+                return *this;
+            }
+
+            const_iterator operator+ (difference_type n) const noexcept
+            {
+                return const_iterator {this->_pos + n};
+            }
+
+            const_iterator operator- (difference_type n) const noexcept
+            {
+                return const_iterator {this->_pos - n};
+            }
+
+            difference_type operator- (const_iterator other) const noexcept
+            {
+                return this->_pos - other._pos;
+            }
+
+            bool operator== (const_iterator other) const noexcept
+            {
+                return this->_pos == other._pos;
+            }
+
+            bool operator!= (const_iterator other) const noexcept
+            {
+                return this->_pos != other._pos;
+            }
+
+            bool operator< (const_iterator other) const noexcept
+            {
+                return this->_pos < other._pos;
+            }
+
+            bool operator> (const_iterator other) const noexcept
+            {
+                return this->_pos > other._pos;
+            }
+
+            bool operator<= (const_iterator other) const noexcept
+            {
+                return this->_pos <= other._pos;
+            }
+
+            bool operator>= (const_iterator other) const noexcept
+            {
+                return this->_pos >= other._pos;
+            }
+
+        private:
+            image_node const * _pos;
+        };
+
+        using iterator = const_iterator;
+
+        /*
+         * Attaches to a serialized image of length bytes starting at data.
+         * Throws std::runtime_error if the image header is malformed or the
+         * length does not cover the declared record count.
+         */
+        bstree_view (void const * data,
+                     size_type length,
+                     Compare comp = Compare ())
+            : _key_comp {comp}
+        {
+            if (length < sizeof (detail::bstree_image_header)) {
+                throw std::runtime_error {
+                    "dsa::bstree_view: image is smaller than its header"
+                };
+            }
+
+            detail::bstree_image_header header;
+            std::memcpy (&header, data, sizeof header);
+
+            if (header.magic != detail::bstree_image_magic) {
+                throw std::runtime_error {
+                    "dsa::bstree_view: bad magic; not a bstree image"
+                };
+            }
+
+            if (header.version != detail::bstree_image_version) {
+                throw std::runtime_error {
+                    "dsa::bstree_view: unsupported image version"
+                };
+            }
+
+            /*
+             * phrased as a division so that a corrupt count near 2^64
+             * cannot wrap the byte total and slip past the check; length
+             * covers the header already, per the check above.
+             */
+            if (header.count >
+                (length - sizeof header) / sizeof (image_node))
+            {
+                throw std::runtime_error {
+                    "dsa::bstree_view: image is truncated"
+                };
+            }
+
+            this->_records = reinterpret_cast <image_node const *> (
+                static_cast <unsigned char const *> (data) + sizeof header
+            );
+            this->_count = static_cast <size_type> (header.count);
+            this->_root  = header.root;
+        }
+
+        ~bstree_view (void) = default;
+
+        bstree_view (bstree_view const &) = default;
+        bstree_view & operator= (bstree_view const &) = default;
+
+        size_type size (void) const noexcept
+        {
+            return this->_count;
+        }
+
+        bool empty (void) const noexcept
+        {
+            return this->_count == 0;
+        }
+
+        key_compare key_comp (void) const
+        {
+            return this->_key_comp;
+        }
+
+        const_iterator begin (void) const noexcept
+        {
+            return const_iterator {this->_records};
+        }
+
+        const_iterator cbegin (void) const noexcept
+        {
+            return this->begin ();
+        }
+
+        const_iterator end (void) const noexcept
+        {
+            return const_iterator {this->_records + this->_count};
+        }
+
+        const_iterator cend (void) const noexcept
+        {
+            return this->end ();
+        }
+
+        const_iterator lower_bound (value_type const & key) const
+        {
+            auto k = this->_root;
+            auto best = detail::bstree_image_npos;
+
+            while (k != detail::bstree_image_npos) {
+                auto const & rec = this->_records [k];
+
+                if (this->_key_comp (rec.value, key)) {
+                    k = rec.right;
+                } else {
+                    best = k;
+                    k = rec.left;
+                }
+            }
+
+            if (best == detail::bstree_image_npos) {
+                return this->end ();
+            } else {
+                return const_iterator {this->_records + best};
+            }
+        }
+
+        const_iterator upper_bound (value_type const & key) const
+        {
+            auto k = this->_root;
+            auto best = detail::bstree_image_npos;
+
+            while (k != detail::bstree_image_npos) {
+                auto const & rec = this->_records [k];
+
+                if (this->_key_comp (key, rec.value)) {
+                    best = k;
+                    k = rec.left;
+                } else {
+                    k = rec.right;
+                }
+            }
+
+            if (best == detail::bstree_image_npos) {
+                return this->end ();
+            } else {
+                return const_iterator {this->_records + best};
+            }
+        }
+
+        const_iterator find (value_type const & key) const
+        {
+            auto const lb = this->lower_bound (key);
+
+            if (lb != this->end () && !this->_key_comp (key, *lb)) {
+                return lb;
+            } else {
+                return this->end ();
+            }
+        }
+
+        size_type count (value_type const & key) const
+        {
+            return this->find (key) != this->end () ? 1 : 0;
+        }
+
+        bool contains (value_type const & key) const
+        {
+            return this->find (key) != this->end ();
+        }
+
+    private:
+        image_node const * _records;
+        size_type          _count;
+        std::uint64_t      _root;
+        key_compare        _key_comp;
+    };
+
     template <
         class Key,
         class Compare = std::less <Key>,
-        class Allocator = std::allocator <Key>
+        class Allocator = std::allocator <Key>,
+        class BalancePolicy = balance::none,
+        class AugmentPolicy = augment::none
     >
     class bstree
     {
+        using is_avl = std::is_same <BalancePolicy, balance::avl>;
+        using is_augmented =
+            std::is_same <AugmentPolicy, augment::subtree_size>;
+
     public:
         using key_type               = Key;
         using value_type             = Key;
@@ -332,29 +1155,37 @@ namespace detail
     private:
         using alloc_traits = std::allocator_traits <allocator_type>;
         using propogate_on_copy_assign =
-            typename alloc_traits::propogate_on_container_copy_assignment;
+            typename alloc_traits::propagate_on_container_copy_assignment;
         using propogate_on_move_assign =
-            typename alloc_traits::propogate_on_container_move_assignment;
+            typename alloc_traits::propagate_on_container_move_assignment;
         using propogate_on_swap =
-            typename alloc_traits::propogate_on_container_swap;
+            typename alloc_traits::propagate_on_container_swap;
 
         enum class branch
         {
             left, right
         };
 
-        struct node
+        using augment_base = typename std::conditional <
+            is_augmented::value,
+            detail::subtree_size_base,
+            detail::no_augment_base
+        >::type;
+
+        struct node : augment_base
         {
             value_type value;
             node * left;
             node * right;
             node * parent;
+            std::size_t height;
 
             node (value_type && val, node * p = nullptr)
                 : value  {std::move (val)}
                 , left   {nullptr}
                 , right  {nullptr}
                 , parent {p}
+                , height {1}
             {}
 
             node (value_type const & val, node * p = nullptr)
@@ -362,6 +1193,7 @@ namespace detail
                 , left   {nullptr}
                 , right  {nullptr}
                 , parent {p}
+                , height {1}
             {}
 
             node (node && other)
@@ -372,10 +1204,14 @@ namespace detail
                 , left   {other.left}
                 , right  {other.right}
                 , parent {other.parent}
+                , height {other.height}
             {
+                this->assign (other);
                 other.left   = nullptr;
                 other.right  = nullptr;
                 other.parent = nullptr;
+                other.height = 1;
+                other.clear ();
             }
 
             ~node (void)
@@ -394,7 +1230,8 @@ namespace detail
         using const_reverse_iterator = std::reverse_iterator <const_iterator>;
 
     private:
-        using node_allocator = typename allocator_type::template rebind <node>;
+        using node_allocator =
+            typename alloc_traits::template rebind_alloc <node>;
         using tree_deleter   = std::function <void (node *)>;
         using node_handle    = std::unique_ptr <node, tree_deleter>;
 
@@ -454,6 +1291,8 @@ namespace detail
 
             // copy root value
             result.reset (node_create (nullptr, a, nh->value));
+            result->height = nh->height;
+            result->assign (*nh);
 
             // copy tree
             auto copy_walk = nh.get ();
@@ -467,6 +1306,8 @@ namespace detail
                     result_walk->left = node_create (
                         result_walk, a, copy_walk->left->value
                     );
+                    result_walk->left->height = copy_walk->left->height;
+                    result_walk->left->assign (*copy_walk->left);
                     copy_walk = copy_walk->left;
                     result_walk = result_walk->left;
                 // Can/Should we move down the right branch? If so, copy that
@@ -475,6 +1316,8 @@ namespace detail
                     result_walk->right = node_create (
                         result_walk, a, copy_walk->right->value
                     );
+                    result_walk->right->height = copy_walk->right->height;
+                    result_walk->right->assign (*copy_walk->right);
                     copy_walk = copy_walk->right;
                     result_walk = result_walk->right;
                 // Otherwise we're either at a leaf node or a node that has
@@ -498,6 +1341,8 @@ namespace detail
 
             // copy root value
             result.reset (node_create (nullptr, a, nh->value));
+            result->height = nh->height;
+            result->assign (*nh);
 
             // copy tree
             auto copy_walk = nh.get ();
@@ -511,6 +1356,8 @@ namespace detail
                     result_walk->left = node_create (
                         result_walk, a, std::move (copy_walk->left->value)
                     );
+                    result_walk->left->height = copy_walk->left->height;
+                    result_walk->left->assign (*copy_walk->left);
                     copy_walk = copy_walk->left;
                     result_walk = result_walk->left;
                 // Can/Should we move down the right branch? If so, copy that
@@ -519,6 +1366,8 @@ namespace detail
                     result_walk->right = node_create (
                         result_walk, a, std::move (copy_walk->right->value)
                     );
+                    result_walk->right->height = copy_walk->right->height;
+                    result_walk->right->assign (*copy_walk->right);
                     copy_walk = copy_walk->right;
                     result_walk = result_walk->right;
                 // Otherwise we're either at a leaf node or a node that has
@@ -532,6 +1381,53 @@ namespace detail
             return result;
         }
 
+        /*
+         * Builds a perfectly height-balanced subtree of count nodes from a
+         * sorted run of unique keys in a single in-order pass, consuming the
+         * iterator by reference; used by the bulk-load interface. Nodes are
+         * allocated in strictly increasing in-order position, so bulk-loaded
+         * trees allocated from a pooling allocator are also laid out
+         * contiguously in traversal order.
+         */
+        template <class ForwardIt>
+        node * build_sorted (ForwardIt & first, size_type count)
+        {
+            if (count == 0) {
+                return nullptr;
+            }
+
+            auto const left_count = count / 2;
+            auto const l = this->build_sorted (first, left_count);
+
+            node * n = nullptr;
+            try {
+                n = node_create (nullptr, this->_node_alloc, *first);
+            } catch (...) {
+                tree_delete (l, this->_node_alloc);
+                std::rethrow_exception (std::current_exception ());
+            }
+
+            ++first;
+            n->left = l;
+            if (l) {
+                l->parent = n;
+            }
+
+            try {
+                n->right = this->build_sorted (first, count - left_count - 1);
+            } catch (...) {
+                tree_delete (n, this->_node_alloc);
+                std::rethrow_exception (std::current_exception ());
+            }
+
+            if (n->right) {
+                n->right->parent = n;
+            }
+
+            pull_up (n);
+            return n;
+        }
+
         template <class ... Args>
         void make_root (Args && ... args)
         {
@@ -545,6 +1441,7 @@ namespace detail
                 this->_tree_root.get (), iterator::state::after_end
             };
             this->_tree_size = 1;
+            this->publish_root ();
         }
 
         void make_root (node * n)
@@ -555,28 +1452,34 @@ namespace detail
                 this->_tree_root.get (), iterator::state::after_end
             };
             this->_tree_size = 1;
+            this->publish_root ();
         }
 
         template <class ... Args>
         void insert_left (node * const parent, Args && ... args)
         {
-            parent->left = node_create (
-                parent, this->_node_alloc, std::forward <Args> (args)...
+            /* the release store publishes the fully constructed node to
+             * lock free readers in concurrent read mode */
+            detail::link_store_release (
+                &parent->left,
+                node_create (
+                    parent, this->_node_alloc, std::forward <Args> (args)...
+                )
             );
             this->_tree_size += 1;
 
-            if (parent == this->_begin) {
+            if (this->_begin._iter == parent) {
                 this->_begin = parent->left;
             }
         }
 
         void insert_left (node * const parent, node * const n)
         {
-            parent->left = n;
             n->parent = parent;
+            detail::link_store_release (&parent->left, n);
             this->_tree_size += 1;
 
-            if (parent == this->_begin) {
+            if (this->_begin._iter == parent) {
                 this->_begin = parent->left;
             }
         }
@@ -595,23 +1498,26 @@ namespace detail
         template <class ... Args>
         void insert_right (node * const parent, Args && ... args)
         {
-            parent->right = node_create (
-                parent, this->_node_alloc, std::forward <Args> (args)...
+            detail::link_store_release (
+                &parent->right,
+                node_create (
+                    parent, this->_node_alloc, std::forward <Args> (args)...
+                )
             );
             this->_tree_size += 1;
 
-            if (parent == this->_end) {
+            if (this->_end._iter == parent) {
                 this->_end = parent->right;
             }
         }
 
         void insert_right (node * const parent, node * const n)
         {
-            parent->right = n;
             n->parent = parent;
+            detail::link_store_release (&parent->right, n);
             this->_tree_size += 1;
 
-            if (parent == this->_end) {
+            if (this->_end._iter == parent) {
                 this->_end = parent->right;
             }
         }
@@ -629,20 +1535,20 @@ namespace detail
 
         iterator insert_at (iterator pos, value_type const & value)
         {
-            if (this->_key_comp (value, pos->value)) {
-                assert (!pos->left);
-                this->insert_left (pos._iter, value);
-                if (pos == this->_begin) {
-                    this->_begin = iterator {pos->left};
-                }
-                return iterator {pos->left};
-            } else if (this->_key_comp (pos->value, value)) {
-                assert (!pos->right);
-                this->insert_right (pos._iter, value);
-                if (pos == this->_end) {
-                    this->_end = iterator {pos->right};
-                }
-                return iterator {pos->right};
+            auto const p = pos._iter;
+
+            if (this->_key_comp (value, p->value)) {
+                assert (!p->left);
+                this->insert_left (p, value);
+                auto const inserted = p->left;
+                this->retrace (p);
+                return iterator {inserted};
+            } else if (this->_key_comp (p->value, value)) {
+                assert (!p->right);
+                this->insert_right (p, value);
+                auto const inserted = p->right;
+                this->retrace (p);
+                return iterator {inserted};
             } else {
                 return pos;
             }
@@ -650,20 +1556,18 @@ namespace detail
 
         std::pair <iterator, bool> insert_at (iterator pos, node * const n)
         {
-            if (this->_key_comp (n->value, pos->value)) {
-                assert (!pos->left);
-                this->insert_left (pos._iter, n);
-                if (pos == this->_begin) {
-                    this->_begin = iterator {pos->left};
-                }
-                return std::make_pair (iterator {pos->left}, true);
-            } else if (this->_key_comp (pos->value, n->value)) {
-                assert (!pos->right);
-                this->insert_right (pos._iter, n);
-                if (pos == this->_end) {
-                    this->_end = iterator {pos->right};
-                }
-                return std::make_pair (iterator {pos->right}, true);
+            auto const p = pos._iter;
+
+            if (this->_key_comp (n->value, p->value)) {
+                assert (!p->left);
+                this->insert_left (p, n);
+                this->retrace (p);
+                return std::make_pair (iterator {n}, true);
+            } else if (this->_key_comp (p->value, n->value)) {
+                assert (!p->right);
+                this->insert_right (p, n);
+                this->retrace (p);
+                return std::make_pair (iterator {n}, true);
             } else {
                 return std::make_pair (pos, false);
             }
@@ -676,7 +1580,7 @@ namespace detail
                 while (l->left) {
                     l = l->left;
                 }
-                this->_begin = l;
+                this->_begin = iterator {l};
 
                 auto r = this->_tree_root.get ();
                 while (r->right) {
@@ -712,69 +1616,325 @@ namespace detail
             auto r = n->right;
             auto b = r->left;
 
-            if (this->_tree_root == n) {
+            r->parent = p;
+
+            if (this->_tree_root.get () == n) {
                 this->_tree_root.release ();
                 this->_tree_root.reset (r);
             } else {
-                r->parent = p;
-
                 if (p->left == n)
                     p->left = r;
                 else
                     p->right = r;
             }
 
-            r->left   = n;
-            n->parent = r;
-            n->right  = b;
-            if (b)
-                b->parent = n;
+            r->left   = n;
+            n->parent = r;
+            n->right  = b;
+            if (b)
+                b->parent = n;
+
+            pull_up (n);
+            pull_up (r);
+
+            return r;
+        }
+
+        /*
+         * Transforms the left tree into the right tree:
+         *
+         *     P         P
+         *     \\        \\
+         *      N         L
+         *    // \\     // \\
+         *    L   C     A   N
+         *  // \\         // \\
+         *  A   B         B   C
+         *
+         *  returns the pointer to the node occupying the position of L,
+         *  if such a node exists, and nullptr otherwise.
+         */
+        node * rotate_right (node * n) noexcept
+        {
+            if (!n || !n->left)
+                return nullptr;
+
+            auto p = n->parent;
+            auto l = n->left;
+            auto b = l->right;
+
+            l->parent = p;
+
+            if (this->_tree_root.get () == n) {
+                this->_tree_root.release ();
+                this->_tree_root.reset (l);
+            } else {
+                if (p->left == n)
+                    p->left = l;
+                else
+                    p->right = l;
+            }
+
+            l->right  = n;
+            n->parent = l;
+            n->left   = b;
+            if (b)
+                b->parent = n;
+
+            pull_up (n);
+            pull_up (l);
+
+            return l;
+        }
+
+        static std::size_t node_height (node const * n) noexcept
+        {
+            return n ? n->height : 0;
+        }
+
+        /* recomputes the bookkeeping of n from that of its children */
+        static void pull_up (node * n) noexcept
+        {
+            n->height = 1 + std::max (
+                node_height (n->left), node_height (n->right)
+            );
+            pull_up_augment (n, is_augmented {});
+        }
+
+        static void pull_up_augment (node *, std::false_type) noexcept {}
+
+        static void pull_up_augment (node * n, std::true_type) noexcept
+        {
+            n->subtree_size =
+                1 + node_count (n->left) + node_count (n->right);
+        }
+
+        /* only meaningful under augment::subtree_size */
+        static std::size_t node_count (node const * n) noexcept
+        {
+            return n ? n->subtree_size : 0;
+        }
+
+        /* left-heavy subtrees have positive balance factors */
+        static std::ptrdiff_t balance_of (node const * n) noexcept
+        {
+            return static_cast <std::ptrdiff_t> (node_height (n->left)) -
+                   static_cast <std::ptrdiff_t> (node_height (n->right));
+        }
+
+        /*
+         * Walks from n up to the root recomputing per-node bookkeeping after
+         * an insertion or erasure below n; under the balance::avl policy any
+         * node found outside the AVL balance invariant is repaired with the
+         * appropriate single or double rotation on the way up.
+         */
+        void retrace (node * n) noexcept
+        {
+            while (n) {
+                pull_up (n);
+
+                if (is_avl::value) {
+                    auto const b = balance_of (n);
+
+                    if (b > 1) {
+                        /* left-right case reduces to left-left */
+                        if (balance_of (n->left) < 0) {
+                            this->rotate_left (n->left);
+                        }
+                        n = this->rotate_right (n);
+                    } else if (b < -1) {
+                        /* right-left case reduces to right-right */
+                        if (balance_of (n->right) > 0) {
+                            this->rotate_right (n->right);
+                        }
+                        n = this->rotate_left (n);
+                    }
+                }
+
+                n = n->parent;
+            }
+        }
+
+        /*
+         * Recomputes the cached heights of every node in O(N) time and O(1)
+         * space via a post-order walk over the parent links; used after
+         * whole-tree reshaping (rebalance ()), where maintaining heights
+         * rotation-by-rotation would be wasted work.
+         */
+        void recompute_heights (void) noexcept
+        {
+            node * prev = nullptr;
+            auto n = this->_tree_root.get ();
+
+            while (n) {
+                auto const from_parent = prev == n->parent;
+                auto const from_left   = n->left && prev == n->left;
+
+                if (from_parent && n->left) {
+                    prev = n;
+                    n = n->left;
+                } else if ((from_parent || from_left) && n->right) {
+                    prev = n;
+                    n = n->right;
+                } else {
+                    pull_up (n);
+                    prev = n;
+                    n = n->parent;
+                }
+            }
+        }
+
+        /*
+         * field accessors for the possibly unaligned records of an image
+         * buffer; offset selects the left or right link of the record.
+         */
+        static std::uint64_t load_image_link (unsigned char const * records,
+                                              std::uint64_t slot,
+                                              std::size_t offset) noexcept
+        {
+            std::uint64_t v;
+            std::memcpy (
+                &v,
+                records +
+                    slot * sizeof (detail::bstree_image_node <Key>) + offset,
+                sizeof v
+            );
+            return v;
+        }
+
+        static void store_image_link (unsigned char * records,
+                                      std::uint64_t slot,
+                                      std::size_t offset,
+                                      std::uint64_t v) noexcept
+        {
+            std::memcpy (
+                records +
+                    slot * sizeof (detail::bstree_image_node <Key>) + offset,
+                &v, sizeof v
+            );
+        }
+
+        /*
+         * Writes the record array of a serialized image for the whole
+         * tree into buffer, assigning slots in in-order sequence, and
+         * returns the root's slot (bstree_image_npos for an empty tree).
+         *
+         * Two iterative in-order walks over the parent links keep stack
+         * use constant, like the file's other whole-tree walks; a
+         * recursive emission would overflow the stack on a degenerate
+         * tree of modest size. The ascending walk writes each record's
+         * value and resolves right links, the descending walk resolves
+         * left links: in either direction the child a link points at is
+         * visited after its parent, so the still-unfilled link fields
+         * double as a chain of pending patches threaded through the
+         * image, popped (last in, first out) whenever the walk visits a
+         * right (respectively left) child.
+         */
+        std::uint64_t emit_image (unsigned char * buffer) const
+        {
+            using image_node = detail::bstree_image_node <Key>;
+
+            constexpr std::size_t left_off =
+                offsetof (image_node, left);
+            constexpr std::size_t right_off =
+                offsetof (image_node, right);
+
+            if (this->empty ()) {
+                return detail::bstree_image_npos;
+            }
+
+            auto const records = buffer +
+                sizeof (detail::bstree_image_header);
+
+            auto root_slot = detail::bstree_image_npos;
+            auto top_right = detail::bstree_image_npos;
+            std::uint64_t slot = 0;
+
+            auto n = static_cast <node const *> (this->_tree_root.get ());
+            while (n->left) {
+                n = n->left;
+            }
+
+            while (n) {
+                image_node rec;
+                rec.left  = detail::bstree_image_npos;
+                rec.right = detail::bstree_image_npos;
+                rec.value = n->value;
+
+                std::memcpy (
+                    records + slot * sizeof (image_node), &rec, sizeof rec
+                );
+
+                if (!n->parent) {
+                    root_slot = slot;
+                } else if (n == n->parent->right) {
+                    /* patch the parent's right link with this slot */
+                    auto const pending = top_right;
+                    top_right = load_image_link (
+                        records, pending, right_off
+                    );
+                    store_image_link (records, pending, right_off, slot);
+                }
+
+                if (n->right) {
+                    /* this record's right link awaits the right child */
+                    store_image_link (records, slot, right_off, top_right);
+                    top_right = slot;
+                }
+
+                slot += 1;
+
+                if (n->right) {
+                    n = n->right;
+                    while (n->left) {
+                        n = n->left;
+                    }
+                } else {
+                    while (n->parent && n == n->parent->right) {
+                        n = n->parent;
+                    }
+                    n = n->parent;
+                }
+            }
+
+            auto top_left = detail::bstree_image_npos;
+            slot = this->_tree_size;
 
-            return r;
-        }
+            n = static_cast <node const *> (this->_tree_root.get ());
+            while (n->right) {
+                n = n->right;
+            }
 
-        /*
-         * Transforms the left tree into the right tree:
-         *
-         *     P         P
-         *     \\        \\
-         *      N         L
-         *    // \\     // \\
-         *    L   C     A   N
-         *  // \\         // \\
-         *  A   B         B   C
-         *
-         *  returns the pointer to the node occupying the position of L,
-         *  if such a node exists, and nullptr otherwise.
-         */
-        node * rotate_right (node * n) noexcept
-        {
-            if (!n || !n->left)
-                return nullptr;
+            while (n) {
+                slot -= 1;
 
-            auto p = n->parent;
-            auto l = n->left;
-            auto b = l->right;
+                if (n->parent && n == n->parent->left) {
+                    /* patch the parent's left link with this slot */
+                    auto const pending = top_left;
+                    top_left = load_image_link (records, pending, left_off);
+                    store_image_link (records, pending, left_off, slot);
+                }
 
-            if (this->_tree_root == n) {
-                this->_tree_root.release ();
-                this->_tree_root.reset (l);
-            } else {
-                l->parent = p;
+                if (n->left) {
+                    /* this record's left link awaits the left child */
+                    store_image_link (records, slot, left_off, top_left);
+                    top_left = slot;
+                }
 
-                if (p->left == n)
-                    p->left = l;
-                else
-                    p->right = l;
+                if (n->left) {
+                    n = n->left;
+                    while (n->right) {
+                        n = n->right;
+                    }
+                } else {
+                    while (n->parent && n == n->parent->left) {
+                        n = n->parent;
+                    }
+                    n = n->parent;
+                }
             }
 
-            l->right  = n;
-            n->parent = l;
-            n->left   = b;
-            if (b)
-                b->parent = n;
-
-            return l;
+            return root_slot;
         }
 
         key_compare    _key_comp;
@@ -784,12 +1944,30 @@ namespace detail
         iterator       _begin;
         iterator       _end;
 
+        /*
+         * state backing the concurrent read mode; the registry is
+         * allocated by enable_concurrent_reads and absent otherwise, so
+         * trees that never enable the mode pay only for three empty
+         * members. _croot mirrors the root link and is the entry point
+         * for lock free traversals: it is (re)published with release
+         * ordering only once the tree is consistent again, so readers
+         * racing a root replacement continue through the retired node.
+         */
+        std::unique_ptr <detail::epoch_registry> _epochs;
+        std::vector <std::pair <std::size_t, node *>> _retired;
+        node * _croot {nullptr};
+
     public:
         bstree (void)
             : bstree (Compare (), Allocator ())
         {}
 
-        ~bstree (void) = default;
+        ~bstree (void)
+        {
+            /* no reader may outlive the tree, so pending retirements can
+             * be released without consulting the epoch horizon */
+            this->release_retired ();
+        }
 
         explicit bstree (Compare const & key_comp,
                          Allocator const & key_alloc = Allocator ())
@@ -840,6 +2018,27 @@ namespace detail
             this->insert (first, last);
         }
 
+        template <class ForwardIt>
+        bstree (sorted_unique_t,
+                ForwardIt first,
+                ForwardIt last,
+                Compare const & key_comp    = Compare (),
+                Allocator const & key_alloc = Allocator ())
+            : _key_comp   {key_comp}
+            , _node_alloc {key_alloc}
+            , _tree_root  {
+                nullptr,
+                std::bind (
+                    tree_delete, std::placeholders::_1, this->_node_alloc
+                )
+            }
+            , _tree_size {0}
+            , _begin     {}
+            , _end       {}
+        {
+            this->assign_sorted (first, last);
+        }
+
         bstree (bstree const & other, Allocator const & alloc)
             : _key_comp   {other._key_comp}
             , _node_alloc {alloc}
@@ -911,7 +2110,7 @@ namespace detail
 
         bstree & operator= (bstree && other)
             noexcept (
-                alloc_traits::is_always_equal::value &&
+                std::is_empty <node_allocator>::value &&
                 std::is_nothrow_move_assignable <Compare>::value
             )
         {
@@ -1004,12 +2203,12 @@ namespace detail
 
         const_iterator begin (void) const noexcept
         {
-            return const_iterator {this->_begin._iter};
+            return const_iterator {this->_begin};
         }
 
         const_iterator cbegin (void) const noexcept
         {
-            return const_iterator {this->_begin._iter};
+            return const_iterator {this->_begin};
         }
 
         iterator end (void) noexcept
@@ -1019,12 +2218,12 @@ namespace detail
 
         const_iterator end (void) const noexcept
         {
-            return const_iterator {this->_end._iter};
+            return const_iterator {this->_end};
         }
 
         const_iterator cend (void) const noexcept
         {
-            return const_iterator {this->_end._iter};
+            return const_iterator {this->_end};
         }
 
         reverse_iterator rbegin (void) noexcept
@@ -1063,6 +2262,337 @@ namespace detail
             this->_begin = iterator {};
             this->_end = iterator {};
             this->_tree_root.reset ();
+            this->publish_root ();
+        }
+
+        /*
+         * Concurrent read mode
+         * --------------------
+         *
+         * After enable_concurrent_reads () has been called, a single
+         * writer thread may keep calling insert () and erase () while any
+         * number of reader threads perform lock free lookups through
+         * contains (key, guard). Each reader pins the current epoch by
+         * constructing a read_guard; nodes removed by erase () are only
+         * retired, and are destroyed once every reader that could still
+         * reach them has released its guard, so readers never touch freed
+         * memory. Writers publish link stores with release ordering and
+         * readers traverse with acquire loads.
+         *
+         * Lookups racing a concurrent insert or erase of the probed key
+         * may report either outcome; lookups of keys that are not being
+         * concurrently modified are always exact, including while an
+         * unrelated two-child erase relocates a subtree (the subtree is
+         * linked into its new position before the erased node is
+         * unlinked, so no key is ever transiently unreachable).
+         *
+         * The mode requires balance::none: AVL rotations restructure the
+         * tree in orders that are not publication safe. Only insert (),
+         * erase () and guarded lookups participate in the protocol —
+         * iteration, assignment, swap () and clear () still require
+         * exclusive access — and the mode does not propagate across copy
+         * or move construction. Destroying the tree, or calling any
+         * member other than contains (key, guard) from a reader thread,
+         * while guards are live is undefined.
+         */
+        class read_guard
+        {
+        public:
+            explicit read_guard (bstree const & tree)
+                : _registry {tree._epochs.get ()}
+            {
+                if (this->_registry == nullptr) {
+                    throw std::runtime_error (
+                        "cannot construct a read_guard for a bstree without "
+                        "concurrent reads enabled"
+                    );
+                }
+
+                this->_slot = this->_registry->claim_slot ();
+                this->_registry->pin (this->_slot);
+            }
+
+            read_guard (read_guard const &) = delete;
+            read_guard & operator= (read_guard const &) = delete;
+
+            ~read_guard (void)
+            {
+                this->_registry->release_slot (this->_slot);
+            }
+
+        private:
+            detail::epoch_registry * _registry;
+            detail::epoch_registry::reader_slot * _slot;
+        };
+
+        void enable_concurrent_reads (void)
+        {
+            static_assert (
+                !is_avl::value,
+                "concurrent reads require balance::none; AVL rotations are "
+                "not publication safe"
+            );
+
+            if (this->_epochs == nullptr) {
+                this->_epochs.reset (new detail::epoch_registry {});
+            }
+
+            this->publish_root ();
+        }
+
+        /*
+         * lock free lookup; safe to call from any thread holding a
+         * read_guard on this tree, concurrently with the single writer.
+         */
+        bool contains (key_type const & key, read_guard const &) const
+        {
+            auto n = detail::link_load_acquire (&this->_croot);
+
+            while (n != nullptr) {
+                if (this->_key_comp (key, n->value)) {
+                    n = detail::link_load_acquire (&n->left);
+                } else if (this->_key_comp (n->value, key)) {
+                    n = detail::link_load_acquire (&n->right);
+                } else {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /*
+         * writer side: forces a reclamation pass over the retired nodes;
+         * erase () already reclaims in batches, so this is only needed to
+         * bound memory during long pauses between erasures.
+         */
+        void reclaim (void)
+        {
+            if (this->_epochs != nullptr) {
+                this->reclaim_retired ();
+            }
+        }
+
+        /*
+         * Splits off every key not less than pivot into a newly returned
+         * tree sharing this tree's comparator and allocator; this tree
+         * keeps the keys less than pivot. The nodes are relinked, never
+         * copied or reallocated.
+         *
+         * Under balance::none the split unstitches the two trees along
+         * the search path of pivot in O(height) structural work (plus an
+         * O(moved) counting walk, which augment::subtree_size reduces to
+         * O(height)). Under balance::avl the nodes above the pivot are
+         * relinked one at a time to preserve the balance invariant,
+         * costing O(moved x log n) but still no allocation.
+         *
+         * The comparator must not throw, and both split and merge require
+         * exclusive access to the trees involved, like clear ().
+         *
+         * Because the nodes are relinked rather than reallocated, the
+         * result's allocator copy must compare equal to this tree's (true
+         * of stateless allocators and of dsa::pool_allocator, whose copies
+         * share one pool); otherwise split throws std::runtime_error, as
+         * merge does for unequal allocators.
+         */
+        bstree split (key_type const & pivot)
+        {
+            bstree result (this->_key_comp, this->get_allocator ());
+
+            if (this->empty ()) {
+                return result;
+            }
+
+            /*
+             * result inherits nodes allocated by this tree's allocator, so
+             * its own allocator must be able to deallocate them; a copy
+             * that compares unequal shares no state and cannot.
+             */
+            if (result._node_alloc != this->_node_alloc) {
+                throw std::runtime_error (
+                    "cannot split a bstree whose allocator copies compare "
+                    "unequal"
+                );
+            }
+
+            if (is_avl::value) {
+                /* relink node by node; each step rebalances both trees */
+                while (true) {
+                    auto pos = this->lower_bound (pivot);
+                    if (pos == this->end ()) {
+                        break;
+                    }
+
+                    auto const n = pos._iter;
+                    this->extract_node (n);
+                    result.insert_node (n);
+                }
+
+                this->publish_root ();
+                return result;
+            }
+
+            /*
+             * descend along the search path of pivot, hooking each node
+             * onto the spine of the tree its subtree belongs to; the two
+             * hooks always point at the deepest unfilled link of their
+             * respective trees.
+             */
+            node * lroot = nullptr;
+            node * rroot = nullptr;
+            node ** lhook = &lroot;
+            node ** rhook = &rroot;
+            node * lparent = nullptr;
+            node * rparent = nullptr;
+
+            auto t = this->_tree_root.release ();
+
+            while (t) {
+                if (this->_key_comp (t->value, pivot)) {
+                    *lhook = t;
+                    t->parent = lparent;
+                    lparent = t;
+                    lhook = &t->right;
+                    t = t->right;
+                } else {
+                    *rhook = t;
+                    t->parent = rparent;
+                    rparent = t;
+                    rhook = &t->left;
+                    t = t->left;
+                }
+            }
+
+            *lhook = nullptr;
+            *rhook = nullptr;
+
+            /* only the nodes on the two spines have stale bookkeeping */
+            for (auto n = lparent; n; n = n->parent) {
+                pull_up (n);
+            }
+            for (auto n = rparent; n; n = n->parent) {
+                pull_up (n);
+            }
+
+            auto const moved = subtree_count (rroot, is_augmented {});
+
+            result._tree_root.reset (rroot);
+            result._tree_size = moved;
+            result.set_iterators ();
+            result.publish_root ();
+
+            this->_tree_root.reset (lroot);
+            this->_tree_size -= moved;
+            this->set_iterators ();
+            this->publish_root ();
+
+            return result;
+        }
+
+        /*
+         * Merges the nodes of other into this tree by relinking, with no
+         * copies and no allocation; nodes whose key is already present
+         * stay behind in other, as with the standard node-based merge.
+         * The trees' allocators must compare equal, and their comparators
+         * are assumed equivalent (this tree's is used for placement).
+         *
+         * When the key ranges do not overlap and neither tree is AVL
+         * balanced, the smaller-keyed tree is grafted wholesale under the
+         * other's extremum in O(height); otherwise the nodes are relinked
+         * one at a time.
+         */
+        void merge (bstree & other)
+        {
+            if (this == &other || other.empty ()) {
+                return;
+            }
+
+            if (this->_node_alloc != other._node_alloc) {
+                throw std::runtime_error (
+                    "cannot merge bstrees with unequal allocators"
+                );
+            }
+
+            if (this->empty ()) {
+                this->_tree_root.reset (other._tree_root.release ());
+                this->_tree_size = other._tree_size;
+                this->set_iterators ();
+                this->publish_root ();
+
+                other._tree_size = 0;
+                other.set_iterators ();
+                other.publish_root ();
+                return;
+            }
+
+            if (!is_avl::value) {
+                /* disjoint ranges: graft the whole tree at an extremum */
+                auto const my_min = this->_begin._iter;
+                auto const my_max = this->_end._iter;
+                auto const other_min = other._begin._iter;
+                auto const other_max = other._end._iter;
+
+                node * graft_at = nullptr;
+                node ** graft_link = nullptr;
+
+                if (this->_key_comp (my_max->value, other_min->value)) {
+                    graft_at = my_max;
+                    graft_link = &my_max->right;
+                } else if (this->_key_comp (other_max->value,
+                                            my_min->value)) {
+                    graft_at = my_min;
+                    graft_link = &my_min->left;
+                }
+
+                if (graft_at != nullptr) {
+                    auto const oroot = other._tree_root.release ();
+                    oroot->parent = graft_at;
+                    *graft_link = oroot;
+                    this->retrace (graft_at);
+
+                    this->_tree_size += other._tree_size;
+                    this->set_iterators ();
+                    this->publish_root ();
+
+                    other._tree_size = 0;
+                    other.set_iterators ();
+                    other.publish_root ();
+                    return;
+                }
+            }
+
+            /*
+             * overlapping ranges (or AVL balancing): relink node by node,
+             * chaining rejected duplicates through their right links so
+             * they can be handed back to other without allocating.
+             */
+            node * rejected = nullptr;
+            node ** reject_tail = &rejected;
+
+            while (!other.empty ()) {
+                auto const n = other._begin._iter;
+                other.extract_node (n);
+
+                if (!this->insert_node (n)) {
+                    *reject_tail = n;
+                    n->right = nullptr;
+                    reject_tail = &n->right;
+                }
+            }
+
+            while (rejected != nullptr) {
+                auto const n = rejected;
+                rejected = n->right;
+                other.insert_node (n);
+            }
+
+            this->publish_root ();
+            other.publish_root ();
+        }
+
+        void merge (bstree && other)
+        {
+            this->merge (other);
         }
 
         /*
@@ -1115,60 +2645,211 @@ namespace detail
             auto m = compute_bound (this->_tree_size + 1);
             rebuild_tree (this->_tree_size - m);
 
-            for (auto k = m / 2; k > 1; k /= 2) {
-                rebuild_tree (k);
+            for (auto k = m / 2; k > 1; k /= 2) {
+                rebuild_tree (k);
+            }
+
+            this->recompute_heights ();
+        }
+
+        /*
+         * Compacts the current contents of the tree into an immutable,
+         * pointer-free bstree_snapshot sharing this tree's comparator. The
+         * snapshot is independent of the tree: it remains valid across (and
+         * reflects none of) subsequent modifications, and may be handed to
+         * reader threads without synchronization. See bstree_snapshot.
+         */
+        bstree_snapshot <Key, Compare> freeze (void) const
+        {
+            return bstree_snapshot <Key, Compare> {
+                this->begin (), this->end (), this->_key_comp
+            };
+        }
+
+        /*
+         * Number of bytes serialize () writes for the current contents of
+         * the tree.
+         */
+        size_type serialized_size (void) const noexcept
+        {
+            return sizeof (detail::bstree_image_header) +
+                this->_tree_size *
+                    sizeof (detail::bstree_image_node <Key>);
+        }
+
+        /*
+         * Writes a relocatable, offset-based image of the tree into buffer,
+         * which must hold at least serialized_size () bytes. The image can
+         * be persisted with a single sequential write and later served
+         * directly from a memory mapping through dsa::bstree_view, or
+         * rebuilt into a live tree in O(n) with assign_sorted () over a
+         * view's iterator range; see bstree_view for the format and its
+         * portability caveats. Requires a trivially copyable Key.
+         */
+        void serialize (unsigned char * buffer) const
+        {
+            static_assert (
+                std::is_trivially_copyable <Key>::value,
+                "bstree images hold raw object representations, so keys "
+                "must be trivially copyable"
+            );
+
+            auto const root = this->emit_image (buffer);
+
+            detail::bstree_image_header header {
+                detail::bstree_image_magic,
+                detail::bstree_image_version,
+                this->_tree_size,
+                root,
+                {0, 0, 0, 0}
+            };
+            std::memcpy (buffer, &header, sizeof header);
+        }
+
+        iterator erase (iterator pos)
+        {
+            auto n = pos._iter;
+            auto retval = pos;
+            ++retval;
+
+            /*
+             * extract_node repoints the cached begin/end iterators before
+             * unlinking; the new extrema after erasing the old minimum
+             * (maximum) are the in-order successor (predecessor) of the
+             * erased node.
+             */
+            this->extract_node (n);
+
+            if (this->_epochs != nullptr) {
+                /*
+                 * concurrent read mode: lock free readers may still be
+                 * traversing n, so destruction and deallocation are
+                 * deferred until every reader pinned at or before this
+                 * epoch has drained.
+                 */
+                this->retire_node (n);
+                this->publish_root ();
+            } else {
+                try {
+                    (&n->value)->~value_type ();
+                } catch (...) {
+                    this->_node_alloc.deallocate (n, 1);
+                    std::rethrow_exception (std::current_exception ());
+                }
+
+                this->_node_alloc.deallocate (n, 1);
+            }
+
+            if (retval._state == iterator::state::after_end) {
+                return this->_end;
+            } else {
+                return retval;
+            }
+        }
+
+    private:
+        /* points the parent (or root) link of old at next */
+        void replace_child (node * const old, node * const next) noexcept
+        {
+            if (next) {
+                next->parent = old->parent;
+            }
+
+            if (this->_tree_root.get () == old) {
+                this->_tree_root.release ();
+                this->_tree_root.reset (next);
+            } else if (old->parent->left == old) {
+                old->parent->left = next;
+            } else {
+                old->parent->right = next;
+            }
+        }
+
+        /*
+         * Unlinks n by replacing it with its in-order successor; the
+         * subsequent retrace restores heights and (under balance::avl) the
+         * AVL balance invariant along the affected path.
+         */
+        void unlink_balanced (node * const n)
+        {
+            node * fixfrom;
+
+            if (n->left && n->right) {
+                auto s = n->right;
+                while (s->left) {
+                    s = s->left;
+                }
+
+                fixfrom = s->parent == n ? s : s->parent;
+
+                /* the successor has no left child by construction */
+                if (s->parent != n) {
+                    s->parent->left = s->right;
+                    if (s->right) {
+                        s->right->parent = s->parent;
+                    }
+                    s->right = n->right;
+                    n->right->parent = s;
+                }
+
+                s->left = n->left;
+                n->left->parent = s;
+
+                this->replace_child (n, s);
+                s->height = n->height;
+            } else {
+                fixfrom = n->parent;
+                this->replace_child (n, n->left ? n->left : n->right);
             }
+
+            this->retrace (fixfrom);
         }
 
-        iterator erase (iterator pos)
+        /* unlinks n in the historical, relocation-based manner */
+        void unlink_relocating (node * const n)
         {
-            auto n = pos._iter;
-            auto const retval = ++pos;
-
             if (!n->left && !n->right) {
-                if (this->_tree_root == n) {
-                    this->_tree_root.reset ();
+                if (this->_tree_root.get () == n) {
+                    /* release, not reset: the caller destroys and
+                     * deallocates n once it is unlinked */
+                    this->_tree_root.release ();
                 } else if (n->parent->left == n) {
-                    n->parent->left = nullptr;
+                    detail::link_store_release <node> (
+                        &n->parent->left, nullptr
+                    );
                 } else if (n->parent->right == n) {
-                    n->parent->right = nullptr;
+                    detail::link_store_release <node> (
+                        &n->parent->right, nullptr
+                    );
                 }
 
-                if (this->_begin == n) {
-                    this->_begin = n->parent;
-                } else if (this->_end == n) {
-                    this->_end = n->parent;
-                }
+                this->retrace (n->parent);
             } else if (!n->left) {
-                if (this->_tree_root == n) {
+                n->right->parent = n->parent;
+
+                if (this->_tree_root.get () == n) {
                     this->_tree_root.release ();
                     this->_tree_root.reset (n->right);
                 } else if (n->parent->left == n) {
-                    n->parent->left = n->right;
+                    detail::link_store_release (&n->parent->left, n->right);
                 } else if (n->parent->right == n) {
-                    n->parent->right = n->right;
+                    detail::link_store_release (&n->parent->right, n->right);
                 }
 
-                n->right->parent = n->parent;
-
-                if (this->_begin == n) {
-                    this->_begin = n->parent;
-                }
+                this->retrace (n->parent);
             } else if (!n->right) {
-                if (this->_tree_root == n) {
+                n->left->parent = n->parent;
+
+                if (this->_tree_root.get () == n) {
                     this->_tree_root.release ();
                     this->_tree_root.reset (n->left);
                 } else if (n->parent->left == n) {
-                    n->parent->left = n->left;
+                    detail::link_store_release (&n->parent->left, n->left);
                 } else if (n->parent->right == n) {
-                    n->parent->right = n->left;
+                    detail::link_store_release (&n->parent->right, n->left);
                 }
 
-                n->left->parent = n->parent;
-
-                if (this->_end == n) {
-                    this->_end = n->parent;
-                }
+                this->retrace (n->parent);
             } else {
                 // we have to remove a node with two children; since we have
                 // access to the node's parent, we can shuffle around the
@@ -1187,32 +2868,14 @@ namespace detail
                 //
                 auto const parity = this->_tree_size % 2 == 0;
 
-                if (this->_tree_root == n) {
-                    this->_tree_root.release ();
-                    if (parity) {
-                        this->_tree_root.reset (n->left);
-                        n->left->parent = nullptr;
-                    } else {
-                        this->_tree_root.reset (n->right);
-                        n->right->parent = nullptr;
-                    }
-                } else {
-                    auto parent = n->parent;
-                    auto branch = n == parent->left ? &parent->left
-                                                    : &parent->right;
-                    if (parity) {
-                        *branch = n->left;
-                        n->left->parent = *branch;
-                    } else {
-                        *branch = n->right;
-                        n->right->parent = *branch;
-                    }
-                }
-
-                // now insert one child into the other's subtree; we know that
-                // the values in the tree are unique, so we do not have to
-                // consider the case when two values compare equal.
+                // first insert one child into the other's subtree; we know
+                // that the values in the tree are unique, so we do not have
+                // to consider the case when two values compare equal. doing
+                // this before unlinking n keeps every key reachable at all
+                // times: concurrent readers racing the relocation observe
+                // the moved subtree through either n or its new position.
                 auto it = parity ? n->left : n->right;
+                auto const keep = it;
                 auto in = parity ? n->right : n->left;
                 while (true)
                 {
@@ -1221,8 +2884,8 @@ namespace detail
                             it = it->left;
                             continue;
                          } else {
-                            it->left = in;
                             in->parent = it;
+                            detail::link_store_release (&it->left, in);
                             break;
                          }
                     } else {
@@ -1230,37 +2893,232 @@ namespace detail
                             it = it->right;
                             continue;
                         } else {
-                            it->right = in;
                             in->parent = it;
+                            detail::link_store_release (&it->right, in);
                             break;
                         }
                     }
                 }
+
+                // now replace n with the child that absorbed the other
+                if (this->_tree_root.get () == n) {
+                    keep->parent = nullptr;
+                    this->_tree_root.release ();
+                    this->_tree_root.reset (keep);
+                } else {
+                    auto parent = n->parent;
+                    keep->parent = parent;
+
+                    if (n == parent->left) {
+                        detail::link_store_release (&parent->left, keep);
+                    } else {
+                        detail::link_store_release (&parent->right, keep);
+                    }
+                }
+
+                this->retrace (in->parent);
             }
+        }
 
-            try {
-                (&n->value)->~value_type ();
-            } catch (...) {
-                this->_tree_size -= 1;
-                this->_node_alloc.deallocate (n, 1);
-                std::rethrow_exception (std::current_exception ());
+        /* republishes the root link to lock free readers; a no-op unless
+         * concurrent reads are enabled */
+        void publish_root (void) noexcept
+        {
+            if (this->_epochs != nullptr) {
+                detail::link_store_release (
+                    &this->_croot, this->_tree_root.get ()
+                );
+            }
+        }
+
+        /* retirements per reclamation scan; scanning amortizes the walk
+         * over the reader slots */
+        static constexpr std::size_t retire_scan_threshold = 64;
+
+        void retire_node (node * const n)
+        {
+            this->_retired.emplace_back (
+                this->_epochs->retire_epoch (), n
+            );
+
+            if (this->_retired.size () >= retire_scan_threshold) {
+                this->reclaim_retired ();
+            }
+        }
+
+        /* destroys and deallocates every retired node that no reader can
+         * still reach */
+        void reclaim_retired (void)
+        {
+            auto const horizon = this->_epochs->horizon ();
+
+            std::size_t i = 0;
+            while (i < this->_retired.size ()) {
+                if (this->_retired [i].first < horizon) {
+                    auto const n = this->_retired [i].second;
+                    this->_retired [i] = this->_retired.back ();
+                    this->_retired.pop_back ();
+
+                    try {
+                        (&n->value)->~value_type ();
+                    } catch (...) {
+                        this->_node_alloc.deallocate (n, 1);
+                        std::rethrow_exception (std::current_exception ());
+                    }
+
+                    this->_node_alloc.deallocate (n, 1);
+                } else {
+                    i += 1;
+                }
+            }
+        }
+
+        /*
+         * unlinks n from the tree without destroying it; the caller takes
+         * ownership of the node, whose links are left stale.
+         */
+        void extract_node (node * const n)
+        {
+            if (this->_tree_size == 1) {
+                this->_begin = iterator {};
+                this->_end = iterator {};
+            } else {
+                if (this->_begin._iter == n) {
+                    auto next = iterator {n};
+                    ++next;
+                    this->_begin = iterator {next._iter};
+                }
+                if (this->_end._iter == n) {
+                    auto prev = iterator {n};
+                    --prev;
+                    this->_end = iterator {
+                        prev._iter, iterator::state::after_end
+                    };
+                }
+            }
+
+            if (is_avl::value) {
+                this->unlink_balanced (n);
+            } else {
+                this->unlink_relocating (n);
             }
 
             this->_tree_size -= 1;
-            this->_node_alloc.deallocate (n, 1);
-            return retval;
         }
 
+        /*
+         * links the detached node n into the tree, retracing from its
+         * insertion point; returns false, leaving n untouched, when an
+         * equal key is already present.
+         */
+        bool insert_node (node * const n)
+        {
+            n->parent = nullptr;
+            n->left = nullptr;
+            n->right = nullptr;
+            pull_up (n);
+
+            if (this->empty ()) {
+                this->make_root (n);
+                return true;
+            }
+
+            auto it = this->_tree_root.get ();
+            while (true) {
+                if (this->_key_comp (n->value, it->value)) {
+                    if (it->left) {
+                        it = it->left;
+                        continue;
+                    }
+                    this->insert_left (it, n);
+                } else if (this->_key_comp (it->value, n->value)) {
+                    if (it->right) {
+                        it = it->right;
+                        continue;
+                    }
+                    this->insert_right (it, n);
+                } else {
+                    return false;
+                }
+
+                this->retrace (it);
+                return true;
+            }
+        }
+
+        /* size of a detached subtree whose root has a null parent link */
+        static size_type subtree_count (node * const root,
+                                        std::true_type) noexcept
+        {
+            return node_count (root);
+        }
+
+        static size_type subtree_count (node * const root,
+                                        std::false_type) noexcept
+        {
+            if (!root) {
+                return 0;
+            }
+
+            /*
+             * in-order walk over the parent links, so that counting a
+             * degenerate subtree needs neither recursion nor a stack.
+             */
+            size_type count = 0;
+            auto n = root;
+            while (n->left) {
+                n = n->left;
+            }
+
+            while (n) {
+                count += 1;
+
+                if (n->right) {
+                    n = n->right;
+                    while (n->left) {
+                        n = n->left;
+                    }
+                } else {
+                    while (n->parent && n == n->parent->right) {
+                        n = n->parent;
+                    }
+                    n = n->parent;
+                }
+            }
+
+            return count;
+        }
+
+        /* unconditionally releases pending retirements; only valid once
+         * no reader can hold a guard */
+        void release_retired (void) noexcept
+        {
+            for (auto const & r : this->_retired) {
+                (&r.second->value)->~value_type ();
+                this->_node_alloc.deallocate (r.second, 1);
+            }
+
+            this->_retired.clear ();
+        }
+
+    public:
         iterator erase (const_iterator first, const_iterator last)
         {
-            for (auto it = first; it != last; ++it)
-                (void) this->erase (it);
+            auto pos = iterator {first._iter};
+            auto const stop = iterator {last._iter, last._state};
 
-            return last;
+            while (pos != stop)
+                pos = this->erase (pos);
+
+            return pos;
         }
 
         size_type erase (key_type const & key)
         {
+            if (this->empty ()) {
+                return 0;
+            }
+
             auto n = this->_tree_root.get ();
 
             // find the erasure point, if it exists, and then perform erasure
@@ -1293,11 +3151,65 @@ namespace detail
             return 0;
         }
 
+        /*
+         * heterogeneous erase; constrained away from types convertible to
+         * an iterator so that erase (iterator)/erase (const_iterator,
+         * const_iterator) keep their usual meaning.
+         */
+        template <
+            class K,
+            class C = key_compare,
+            typename = typename std::enable_if <
+                detail::is_transparent <C>::value &&
+                !std::is_convertible <K, iterator>::value &&
+                !std::is_convertible <K, const_iterator>::value
+            >::type
+        >
+        size_type erase (K const & x)
+        {
+            if (this->empty ()) {
+                return 0;
+            }
+
+            auto n = this->_tree_root.get ();
+
+            // find the erasure point, if it exists, and then perform erasure
+            while (true) {
+                // x is less than the value at n, so walk the left-branch
+                if (this->_key_comp (x, n->value)) {
+                    if (n->left) {
+                        n = n->left;
+                        continue;
+                    } else {
+                        // x was not found, so return 0
+                        break;
+                    }
+                // x is greater than the value at n, so walk the right-branch
+                } else if (this->_key_comp (n->value, x)) {
+                    if (n->right) {
+                        n = n->right;
+                        continue;
+                    } else {
+                        // x was not found, so return 0
+                        break;
+                    }
+                // x compares equal to the value at n, so erase here
+                } else {
+                    (void) this->erase (iterator {n});
+                    return 1;
+                }
+            }
+
+            return 0;
+        }
+
         std::pair <iterator, bool> insert (value_type const & value)
         {
             if (this->empty ()) {
                 this->make_root (value);
-                return std::make_pair (iterator {this->_tree_root}, true);
+                return std::make_pair (
+                    iterator {this->_tree_root.get ()}, true
+                );
             } else {
                 auto n = this->_tree_root.get ();
 
@@ -1310,7 +3222,9 @@ namespace detail
                             continue;
                         } else {
                             this->insert_left (n, value);
-                            return std::make_pair (iterator {n->left}, true);
+                            auto const inserted = n->left;
+                            this->retrace (n);
+                            return std::make_pair (iterator {inserted}, true);
                         }
                     // value is greater than that of n, so walk the right-branch
                     } else if (this->_key_comp (n->value, value)) {
@@ -1319,7 +3233,9 @@ namespace detail
                             continue;
                         } else {
                             this->insert_right (n, value);
-                            return std::make_pair (iterator {n->right}, true);
+                            auto const inserted = n->right;
+                            this->retrace (n);
+                            return std::make_pair (iterator {inserted}, true);
                         }
                     // value compares equal to that of n, so we cannot insert
                     } else {
@@ -1333,7 +3249,9 @@ namespace detail
         {
             if (this->empty ()) {
                 this->make_root (std::move (value));
-                return std::make_pair (iterator {this->_tree_root}, true);
+                return std::make_pair (
+                    iterator {this->_tree_root.get ()}, true
+                );
             } else {
                 auto n = this->_tree_root.get ();
 
@@ -1346,7 +3264,9 @@ namespace detail
                             continue;
                         } else {
                             this->insert_left (n, std::move (value));
-                            return std::make_pair (iterator {n->left}, true);
+                            auto const inserted = n->left;
+                            this->retrace (n);
+                            return std::make_pair (iterator {inserted}, true);
                         }
                     // value is greater than that of n, so walk the right-branch
                     } else if (this->_key_comp (n->value, value)) {
@@ -1355,7 +3275,9 @@ namespace detail
                             continue;
                         } else {
                             this->insert_right (n, std::move (value));
-                            return std::make_pair (iterator {n->right}, true);
+                            auto const inserted = n->right;
+                            this->retrace (n);
+                            return std::make_pair (iterator {inserted}, true);
                         }
                     // value compares equal to that of n, so we cannot insert
                     } else {
@@ -1367,12 +3289,17 @@ namespace detail
 
         iterator insert (const_iterator hint, value_type const & value)
         {
+            if (this->empty ()) {
+                this->make_root (value);
+                return iterator {this->_tree_root.get ()};
+            }
+
             auto pos = iterator {hint._iter};
 
             // attempt iteration backwards to find the lower bound of value
-            if (this->_key_comp (value, pos->value)) {
+            if (this->_key_comp (value, (*pos))) {
                 while (pos != this->_begin &&
-                       this->_key_comp (value, pos->value))
+                       this->_key_comp (value, (*pos)))
                 {
                     --pos;
                 }
@@ -1380,7 +3307,7 @@ namespace detail
             // value
             } else {
                 while (pos != this->_end &&
-                       this->_key_comp (pos->value, value))
+                       this->_key_comp ((*pos), value))
                 {
                     ++pos;
                 }
@@ -1391,12 +3318,17 @@ namespace detail
 
         iterator insert (const_iterator hint, value_type && value)
         {
+            if (this->empty ()) {
+                this->make_root (std::move (value));
+                return iterator {this->_tree_root.get ()};
+            }
+
             auto pos = iterator {hint._iter};
 
             // attempt iteration backwards to find the lower bound of value
-            if (this->_key_comp (value, pos->value)) {
+            if (this->_key_comp (value, (*pos))) {
                 while (pos != this->_begin &&
-                       this->_key_comp (value, pos->value))
+                       this->_key_comp (value, (*pos)))
                 {
                     --pos;
                 }
@@ -1404,7 +3336,7 @@ namespace detail
             // value
             } else {
                 while (pos != this->_end &&
-                       this->_key_comp (pos->value, value))
+                       this->_key_comp ((*pos), value))
                 {
                     ++pos;
                 }
@@ -1425,12 +3357,39 @@ namespace detail
             this->insert (ilist.begin (), ilist.end ());
         }
 
+        /*
+         * Replaces the contents of the tree with the elements of
+         * [first, last) in a single O(n) pass, producing a perfectly
+         * height-balanced tree. The range must already be sorted with
+         * respect to the tree's comparator and must not contain duplicate
+         * keys; use insert (first, last) for arbitrary ranges.
+         */
+        template <class ForwardIt>
+        void assign_sorted (ForwardIt first, ForwardIt last)
+        {
+            this->clear ();
+
+            auto const count = static_cast <size_type> (
+                std::distance (first, last)
+            );
+
+            if (count == 0) {
+                return;
+            }
+
+            this->_tree_root.reset (this->build_sorted (first, count));
+            this->_tree_size = count;
+            this->set_iterators ();
+        }
+
         template <class ... Args>
         std::pair <iterator, bool> emplace (Args && ... args)
         {
             if (this->empty ()) {
                 this->make_root (std::forward <Args> (args)...);
-                return std::make_pair (iterator {this->_tree_root}, true);
+                return std::make_pair (
+                    iterator {this->_tree_root.get ()}, true
+                );
             } else {
                 auto it = this->_tree_root.get ();
                 auto in = node_create (
@@ -1448,9 +3407,8 @@ namespace detail
                                 continue;
                             } else {
                                 this->insert_left (it, in);
-                                return std::make_pair (
-                                    iterator {it->left}, true
-                                );
+                                this->retrace (it);
+                                return std::make_pair (iterator {in}, true);
                             }
                         // value is greater than that of it, so walk the
                         // right-branch
@@ -1460,9 +3418,8 @@ namespace detail
                                 continue;
                             } else {
                                 this->insert_right (it, in);
-                                return std::make_pair (
-                                    iterator {it->right}, true
-                                );
+                                this->retrace (it);
+                                return std::make_pair (iterator {in}, true);
                             }
                         // value compares equal to that of it, so we cannot
                         // insert
@@ -1483,6 +3440,11 @@ namespace detail
         template <class ... Args>
         iterator emplace_hint (const_iterator hint, Args && ... args)
         {
+            if (this->empty ()) {
+                this->make_root (std::forward <Args> (args)...);
+                return iterator {this->_tree_root.get ()};
+            }
+
             auto pos = iterator {hint._iter};
             auto in = node_create (
                 nullptr, this->_node_alloc, std::forward <Args> (args)...
@@ -1490,9 +3452,9 @@ namespace detail
 
             try {
                 // attempt iteration backwards to find the lower bound of value
-                if (this->_key_comp (in->value, pos->value)) {
+                if (this->_key_comp (in->value, (*pos))) {
                     while (pos != this->_begin &&
-                           this->_key_comp (in->value, pos->value))
+                           this->_key_comp (in->value, (*pos)))
                     {
                         --pos;
                     }
@@ -1500,7 +3462,7 @@ namespace detail
                 // of value
                 } else {
                     while (pos != this->_end &&
-                           this->_key_comp (pos->value, in->value))
+                           this->_key_comp ((*pos), in->value))
                     {
                         ++pos;
                     }
@@ -1558,8 +3520,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         size_type count (K const & x) const
@@ -1639,8 +3602,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         iterator find_impl (K const & x) const
@@ -1693,8 +3657,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         iterator find (K const & x)
@@ -1704,8 +3669,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         const_iterator find (K const & x) const
@@ -1725,8 +3691,8 @@ namespace detail
             auto pos = iterator {this->_tree_root.get ()};
 
             // if we start off ahead of key, then move backwards
-            if (this->_key_comp (key, pos->value)) {
-                while (this->_key_comp (key, pos->value)) {
+            if (this->_key_comp (key, (*pos))) {
+                while (this->_key_comp (key, (*pos))) {
                     if (this->_begin == pos) {
                         return pos;
                     } else {
@@ -1735,15 +3701,15 @@ namespace detail
                 }
 
                 // if we went behind key, move forward by one
-                if (this->_key_comp (pos->value, key)) {
+                if (this->_key_comp ((*pos), key)) {
                     return ++pos;
-                // otherwise pos->value and key compare equal
+                // otherwise (*pos) and key compare equal
                 } else {
                     return pos;
                 }
             // otherwise, if we start off behind key, then move forwards
-            } else if (this->_key_comp (pos->value, key)) {
-                while (this->_key_comp (pos->value, key)) {
+            } else if (this->_key_comp ((*pos), key)) {
+                while (this->_key_comp ((*pos), key)) {
                     if (this->_end == pos) {
                         return pos;
                     } else {
@@ -1762,8 +3728,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         iterator lower_bound_impl (K const & x) const
@@ -1777,8 +3744,8 @@ namespace detail
             auto pos = iterator {this->_tree_root.get ()};
 
             // if we start off ahead of x, then move backwards
-            if (this->_key_comp (x, pos->value)) {
-                while (this->_key_comp (x, pos->value)) {
+            if (this->_key_comp (x, (*pos))) {
+                while (this->_key_comp (x, (*pos))) {
                     if (this->_begin == pos) {
                         return pos;
                     } else {
@@ -1787,15 +3754,15 @@ namespace detail
                 }
 
                 // if we went behind x, move forward by one
-                if (this->_key_comp (pos->value, x)) {
+                if (this->_key_comp ((*pos), x)) {
                     return ++pos;
-                // otherwise pos->value and x compare equal
+                // otherwise (*pos) and x compare equal
                 } else {
                     return pos;
                 }
             // otherwise, if we start off behind x, then move forwards
-            } else if (this->_key_comp (pos->value, x)) {
-                while (this->_key_comp (pos->value, x)) {
+            } else if (this->_key_comp ((*pos), x)) {
+                while (this->_key_comp ((*pos), x)) {
                     if (this->_end == pos) {
                         return pos;
                     } else {
@@ -1822,8 +3789,8 @@ namespace detail
             auto pos = iterator {this->_tree_root.get ()};
 
             // if we start off ahead of key, then move backwards
-            if (this->_key_comp (key, pos->value)) {
-                while (this->_key_comp (key, pos->value)) {
+            if (this->_key_comp (key, (*pos))) {
+                while (this->_key_comp (key, (*pos))) {
                     if (this->_begin == pos) {
                         return pos;
                     } else {
@@ -1836,8 +3803,8 @@ namespace detail
                 // at pos, so in either case move forward by one
                 return ++pos;
             // otherwise, if we start off behind key, then move forwards
-            } else if (this->_key_comp (pos->value, key)) {
-                while (this->_key_comp (pos->value, key)) {
+            } else if (this->_key_comp ((*pos), key)) {
+                while (this->_key_comp ((*pos), key)) {
                     if (this->_end == pos) {
                         return pos;
                     } else {
@@ -1846,9 +3813,9 @@ namespace detail
                 }
 
                 // if we went ahead of key, return this position
-                if (this->_key_comp (key, pos->value)) {
+                if (this->_key_comp (key, (*pos))) {
                     return pos;
-                // otherwise pos->value and key compare equal, so move forward
+                // otherwise (*pos) and key compare equal, so move forward
                 // by one
                 } else {
                     return ++pos;
@@ -1861,8 +3828,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         iterator upper_bound_impl (K const & x) const
@@ -1875,8 +3843,8 @@ namespace detail
             auto pos = iterator {this->_tree_root.get ()};
 
             // if we start off ahead of x, then move backwards
-            if (this->_key_comp (x, pos->value)) {
-                while (this->_key_comp (x, pos->value)) {
+            if (this->_key_comp (x, (*pos))) {
+                while (this->_key_comp (x, (*pos))) {
                     if (this->_begin == pos) {
                         return pos;
                     } else {
@@ -1889,8 +3857,8 @@ namespace detail
                 // at pos, so in either case move forward by one
                 return ++pos;
             // otherwise, if we start off behind x, then move forwards
-            } else if (this->_key_comp (pos->value, x)) {
-                while (this->_key_comp (pos->value, x)) {
+            } else if (this->_key_comp ((*pos), x)) {
+                while (this->_key_comp ((*pos), x)) {
                     if (this->_end == pos) {
                         return pos;
                     } else {
@@ -1899,9 +3867,9 @@ namespace detail
                 }
 
                 // if we went ahead of x, return this position
-                if (this->_key_comp (x, pos->value)) {
+                if (this->_key_comp (x, (*pos))) {
                     return pos;
-                // otherwise pos->value and x compare equal, so move forward
+                // otherwise (*pos) and x compare equal, so move forward
                 // by one
                 } else {
                     return ++pos;
@@ -1925,8 +3893,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         iterator lower_bound (K const & x)
@@ -1936,8 +3905,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         const_iterator lower_bound (K const & x) const
@@ -1957,8 +3927,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         iterator upper_bound (K const & x)
@@ -1968,8 +3939,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         const_iterator upper_bound (K const & x) const
@@ -2008,8 +3980,9 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         std::pair <iterator, iterator> equal_range (K const & x)
@@ -2028,11 +4001,13 @@ namespace detail
 
         template <
             class K,
+            class C = key_compare,
             typename = typename std::enable_if <
-                key_compare::is_transparent::value
+                detail::is_transparent <C>::value
             >::type
         >
         std::pair <const_iterator, const_iterator> equal_range (K const & x)
+            const
         {
             // find the lower bound; since we have unique keys the upper bound
             // is always just one-past the lower bound.
@@ -2045,49 +4020,132 @@ namespace detail
 
             return std::make_pair (lower, upper);
         }
+
+        /*
+         * Returns an iterator to the k-th smallest key (zero-based), or the
+         * end iterator if k >= size (); O(log n). Available only under
+         * augment::subtree_size.
+         */
+        template <
+            class A = AugmentPolicy,
+            typename = typename std::enable_if <
+                std::is_same <A, augment::subtree_size>::value
+            >::type
+        >
+        iterator select (size_type k)
+        {
+            if (k >= this->_tree_size) {
+                return this->_end;
+            }
+
+            auto n = this->_tree_root.get ();
+
+            while (true) {
+                auto const below = node_count (n->left);
+
+                if (k < below) {
+                    n = n->left;
+                } else if (k == below) {
+                    return iterator {n};
+                } else {
+                    k -= below + 1;
+                    n = n->right;
+                }
+            }
+        }
+
+        template <
+            class A = AugmentPolicy,
+            typename = typename std::enable_if <
+                std::is_same <A, augment::subtree_size>::value
+            >::type
+        >
+        const_iterator select (size_type k) const
+        {
+            return const_cast <bstree *> (this)->select (k);
+        }
+
+        /*
+         * Returns the number of keys strictly less than key; O(log n).
+         * Available only under augment::subtree_size.
+         */
+        template <
+            class A = AugmentPolicy,
+            typename = typename std::enable_if <
+                std::is_same <A, augment::subtree_size>::value
+            >::type
+        >
+        size_type rank (key_type const & key) const
+        {
+            auto n = this->_tree_root.get ();
+            size_type below = 0;
+
+            while (n) {
+                if (this->_key_comp (n->value, key)) {
+                    below += node_count (n->left) + 1;
+                    n = n->right;
+                } else {
+                    n = n->left;
+                }
+            }
+
+            return below;
+        }
     };
 
-    template <class Key, class Compare, class Alloc>
-    bool operator== (bstree <Key, Compare, Alloc> const & lhs,
-                     bstree <Key, Compare, Alloc> const & rhs)
+    template <
+        class Key, class Compare, class Alloc, class Balance, class Augment
+    >
+    bool operator== (bstree <Key, Compare, Alloc, Balance, Augment> const & lhs,
+                     bstree <Key, Compare, Alloc, Balance, Augment> const & rhs)
     {
         return lhs.size () == rhs.size () &&
             std::equal (lhs.begin (), lhs.end (), rhs.begin ());
     }
 
-    template <class Key, class Compare, class Alloc>
-    bool operator!= (bstree <Key, Compare, Alloc> const & lhs,
-                     bstree <Key, Compare, Alloc> const & rhs)
+    template <
+        class Key, class Compare, class Alloc, class Balance, class Augment
+    >
+    bool operator!= (bstree <Key, Compare, Alloc, Balance, Augment> const & lhs,
+                     bstree <Key, Compare, Alloc, Balance, Augment> const & rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class Key, class Compare, class Alloc>
-    bool operator< (bstree <Key, Compare, Alloc> const & lhs,
-                    bstree <Key, Compare, Alloc> const & rhs)
+    template <
+        class Key, class Compare, class Alloc, class Balance, class Augment
+    >
+    bool operator< (bstree <Key, Compare, Alloc, Balance, Augment> const & lhs,
+                    bstree <Key, Compare, Alloc, Balance, Augment> const & rhs)
     {
         return std::lexicographical_compare (
             lhs.begin (), lhs.end (), rhs.begin (), rhs.end ()
         );
     }
 
-    template <class Key, class Compare, class Alloc>
-    bool operator> (bstree <Key, Compare, Alloc> const & lhs,
-                    bstree <Key, Compare, Alloc> const & rhs)
+    template <
+        class Key, class Compare, class Alloc, class Balance, class Augment
+    >
+    bool operator> (bstree <Key, Compare, Alloc, Balance, Augment> const & lhs,
+                    bstree <Key, Compare, Alloc, Balance, Augment> const & rhs)
     {
         return rhs < lhs;
     }
 
-    template <class Key, class Compare, class Alloc>
-    bool operator<= (bstree <Key, Compare, Alloc> const & lhs,
-                     bstree <Key, Compare, Alloc> const & rhs)
+    template <
+        class Key, class Compare, class Alloc, class Balance, class Augment
+    >
+    bool operator<= (bstree <Key, Compare, Alloc, Balance, Augment> const & lhs,
+                     bstree <Key, Compare, Alloc, Balance, Augment> const & rhs)
     {
         return !(lhs > rhs);
     }
 
-    template <class Key, class Compare, class Alloc>
-    bool operator>= (bstree <Key, Compare, Alloc> const & lhs,
-                     bstree <Key, Compare, Alloc> const & rhs)
+    template <
+        class Key, class Compare, class Alloc, class Balance, class Augment
+    >
+    bool operator>= (bstree <Key, Compare, Alloc, Balance, Augment> const & lhs,
+                     bstree <Key, Compare, Alloc, Balance, Augment> const & rhs)
     {
         return !(lhs < rhs);
     }
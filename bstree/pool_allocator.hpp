@@ -0,0 +1,258 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (pool_allocator.hpp) is part of the dsa project.
+//
+// pool_allocator; a slab-backed pooling allocator for node-based containers
+// such as dsa::bstree, for C++11 or later.
+//
+// A description of pool-based allocation can be found here:
+//
+//      https://en.wikipedia.org/wiki/Memory_pool
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/bstree.hpp
+// license:
+//
+// Copyright (c) 2016 DaltonWoodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_POOL_ALLOCATOR_HPP
+#define DSA_POOL_ALLOCATOR_HPP
+
+#include <cstddef>  // std::ptrdiff_t, std::size_t
+#include <memory>   // std::shared_ptr
+#include <new>      // ::operator new, ::operator delete
+#include <utility>  // std::swap
+#include <vector>   // std::vector
+
+
+namespace dsa
+{
+namespace detail
+{
+    /*
+     * the untyped pool behind pool_allocator; it is deliberately not
+     * parameterized on the allocated type, so that allocators rebound to
+     * different value types (e.g. a container's Key allocator and the node
+     * allocator derived from it) can share one pool, as the C++11 allocator
+     * requirements demand of converted copies. Slots of distinct sizes are
+     * segregated into per-size buckets, each with its own slabs and
+     * freelist.
+     */
+    template <std::size_t SlabSize>
+    class memory_pool
+    {
+    public:
+        memory_pool (void) = default;
+
+        ~memory_pool (void)
+        {
+            /* bulk release; individual objects were destroyed by users */
+            for (auto & b : this->buckets) {
+                for (auto s : b.slabs) {
+                    ::operator delete (s);
+                }
+            }
+        }
+
+        memory_pool (memory_pool const &) = delete;
+        memory_pool & operator= (memory_pool const &) = delete;
+
+        void * obtain (std::size_t slot_size)
+        {
+            auto & b = this->bucket_for (slot_size);
+
+            if (b.freelist) {
+                auto const s = b.freelist;
+                b.freelist = *static_cast <void **> (s);
+                return s;
+            }
+
+            if (b.slab_used == SlabSize) {
+                b.slabs.push_back (::operator new (SlabSize * slot_size));
+                b.slab_used = 0;
+            }
+
+            return static_cast <unsigned char *> (b.slabs.back ()) +
+                slot_size * b.slab_used++;
+        }
+
+        /*
+         * noexcept holds because p was obtained from this pool, so the
+         * bucket for its slot size necessarily already exists.
+         */
+        void recycle (void * p, std::size_t slot_size) noexcept
+        {
+            auto & b = this->bucket_for (slot_size);
+
+            *static_cast <void **> (p) = b.freelist;
+            b.freelist = p;
+        }
+
+    private:
+        /* a recycled slot holds the link to the next free slot in place */
+        struct bucket
+        {
+            std::size_t slot_size;
+            std::vector <void *> slabs;
+            void * freelist;
+            std::size_t slab_used;
+        };
+
+        bucket & bucket_for (std::size_t slot_size)
+        {
+            for (auto & b : this->buckets) {
+                if (b.slot_size == slot_size) {
+                    return b;
+                }
+            }
+
+            this->buckets.push_back (bucket {slot_size, {}, nullptr, SlabSize});
+            return this->buckets.back ();
+        }
+
+        std::vector <bucket> buckets;
+    };
+}   // namespace detail
+
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::pool_allocator <> is an STL-compatible allocator carving fixed-size
+     * allocations out of large contiguous slabs. It is intended for node-based
+     * containers (in particular dsa::bstree) that perform many single-object
+     * allocations: nodes allocated back-to-back land adjacent in memory, which
+     * keeps pointer-chasing traversals friendlier to the cache than individual
+     * heap allocations scattered by a general purpose allocator.
+     *
+     * Single-object deallocations are recycled through an intrusive freelist
+     * in O(1); the slabs themselves are released in bulk when the last
+     * allocator sharing the pool is destroyed. Allocations of more than one
+     * object at a time bypass the pool and are serviced directly by
+     * ::operator new/::operator delete.
+     *
+     * Copies of a pool_allocator (including rebound copies) share the same
+     * underlying pool, and compare equal if and only if they do so; this makes
+     * the allocator safe for use with allocator-aware containers that move or
+     * swap their allocators.
+     *
+     * A dsa::pool_allocator <> is NOT threadsafe; two containers sharing a
+     * pool must not allocate concurrently without external synchronization.
+     *
+     * Template Parameters
+     * -------------------
+     * - T: the object type to be allocated.
+     *
+     * - SlabSize: the number of objects carved from each contiguous slab;
+     *   must be nonzero. The default of 1024 keeps slabs in the tens-of-
+     *   kilobytes range for typical node types.
+     */
+    template <typename T, std::size_t SlabSize = 1024>
+    class pool_allocator
+    {
+        static_assert (SlabSize > 0, "empty slabs are not allowed");
+
+        /*
+         * each pool slot must be able to hold either a live object or a
+         * freelist link to the next recycled slot, at the alignment of
+         * whichever is stricter; slot offsets within a slab stay aligned
+         * because the size is rounded up to a multiple of the alignment.
+         */
+        static constexpr std::size_t slot_align =
+            alignof (T) > alignof (void *) ? alignof (T) : alignof (void *);
+
+        static constexpr std::size_t slot_size =
+            ((sizeof (T) > sizeof (void *) ? sizeof (T) : sizeof (void *)) +
+             slot_align - 1) / slot_align * slot_align;
+
+        std::shared_ptr <detail::memory_pool <SlabSize>> _pool;
+
+        template <typename, std::size_t>
+        friend class pool_allocator;
+
+    public:
+        using value_type      = T;
+        using pointer         = value_type *;
+        using const_pointer   = value_type const *;
+        using reference       = value_type &;
+        using const_reference = value_type const &;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = pool_allocator <U, SlabSize>;
+        };
+
+        pool_allocator (void)
+            : _pool {std::make_shared <detail::memory_pool <SlabSize>> ()}
+        {}
+
+        pool_allocator (pool_allocator const &) noexcept = default;
+        pool_allocator & operator= (pool_allocator const &) noexcept = default;
+
+        ~pool_allocator (void) = default;
+
+        /*
+         * a rebound copy shares the source's pool, so that it compares equal
+         * to its source and can deallocate what the source allocated; the
+         * pool keeps the two value types' slots in separate buckets.
+         */
+        template <typename U>
+        pool_allocator (pool_allocator <U, SlabSize> const & other) noexcept
+            : _pool {other._pool}
+        {}
+
+        pointer allocate (size_type n)
+        {
+            if (n == 1) {
+                return static_cast <pointer> (this->_pool->obtain (slot_size));
+            } else {
+                return static_cast <pointer> (
+                    ::operator new (n * sizeof (value_type))
+                );
+            }
+        }
+
+        void deallocate (pointer p, size_type n) noexcept
+        {
+            if (n == 1) {
+                this->_pool->recycle (static_cast <void *> (p), slot_size);
+            } else {
+                ::operator delete (static_cast <void *> (p));
+            }
+        }
+
+        size_type max_size (void) const noexcept
+        {
+            return std::size_t (-1) / sizeof (value_type);
+        }
+
+        template <typename U>
+        bool operator== (pool_allocator <U, SlabSize> const & other) const
+            noexcept
+        {
+            return this->_pool == other._pool;
+        }
+
+        template <typename U>
+        bool operator!= (pool_allocator <U, SlabSize> const & other) const
+            noexcept
+        {
+            return !(*this == other);
+        }
+    };
+}   // namespace dsa
+
+#endif  // #ifndef DSA_POOL_ALLOCATOR_HPP
@@ -28,18 +28,40 @@
 #ifndef DSA_DYNAMIC_RINGBUFFER_HPP
 #define DSA_DYNAMIC_RINGBUFFER_HPP
 
-#include <exception>    // std::runtime_error
+#include <cstring>      // std::memcpy
 #include <limits>       // std::numeric_limits
 #include <memory>       // std::unique_ptr, std::allocator,
                         // std::allocator_traits
-#include <stdexcept>    // std::length_error
+#include <stdexcept>    // std::length_error, std::runtime_error
 #include <type_traits>  // std::remove_cv, std::is_nothrow_move_constructible,
                         // std::is_nothrow_copy_constructible,
                         // std::is_destructible,
-                        // std::is_nothrow_destructible
+                        // std::is_nothrow_destructible,
+                        // std::is_trivially_copyable
 #include <utility>      // std::forward, std::move, std::swap
 
 
+#ifndef DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+#define DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+namespace dsa
+{
+    /*
+     * is_trivially_relocatable <T> is true when move constructing a T and
+     * destroying the source is equivalent to copying the object
+     * representation and abandoning the source without running its
+     * destructor. Every trivially copyable type qualifies, which is the
+     * default; user defined types whose moves only shuffle bytes may opt
+     * in by specializing this trait before instantiating the containers.
+     *
+     * the definition is repeated, behind this guard, in each header that
+     * relies on it so that the headers remain freestanding; all copies
+     * must stay identical.
+     */
+    template <class T>
+    struct is_trivially_relocatable : std::is_trivially_copyable <T> {};
+}   // namespace dsa
+#endif  // DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+
 namespace dsa
 {
 namespace
@@ -96,7 +118,13 @@ namespace
      *      controls behavior of the container when capacity == 0: if the
      *      value is equal to no_resize then the behavior depends on the
      *      overwrite_policy; if the value is resize then the internal buffer
-     *      is reallocated with a larger maximum capacity.
+     *      is reallocated with a larger maximum capacity; if the value is
+     *      incremental then the internal buffer is likewise reallocated, but
+     *      the existing contents are relocated a bounded number of elements
+     *      per subsequent operation rather than all at once, so that no
+     *      single push or emplace ever pays the full cost of the copy. the
+     *      incremental policy is intended for nothrow move constructible
+     *      element types; see also finish_migration below.
      *
      *  - dynamic_ringbuffer::overwrite_policy [default: no_overwrite]
      *      controls behavior of the container when capacity == 0 and the
@@ -107,6 +135,14 @@ namespace
      *      push/push_back or emplace/emplace_back an exception of type
      *      std::runtime_error is emitted.
      *
+     *  - dynamic_ringbuffer::capacity_policy [default: geometric]
+     *      controls how requested capacities are rounded when the internal
+     *      buffer is (re)allocated: if the value is geometric then capacities
+     *      grow by a constant factor; if the value is power_of_two then
+     *      capacities are rounded up to the next power of two, so that the
+     *      offset of any buffer position from the start of the allocation
+     *      can be reduced with a single mask rather than a division.
+     *
      *  Member Types
      *  ------------
      *  - allocator_type:  Alloc;
@@ -131,18 +167,20 @@ namespace
      *
      *  dynamic_ringbuffer (size_type,
      *                      enum resize_policy = default,
-     *                      enum overwrite_policy = default):
+     *                      enum overwrite_policy = default,
+     *                      enum capacity_policy = default):
      *      - constructs a buffer with capacity sufficienct to hold at least
-     *        the provided size buffered elements; sets resize and overwrite
-     *        policies
+     *        the provided size buffered elements; sets resize, overwrite,
+     *        and capacity policies
      *
      *  dynamic_ringbuffer (size_type,
      *                      allocator_type const &,
      *                      enum resize_policy = default,
-     *                      enum overwrite_policy = default):
+     *                      enum overwrite_policy = default,
+     *                      enum capacity_policy = default):
      *      - constructs a buffer with capacity sufficienct to hold at least
      *        the provided size buffered elements; copy constructs allocator;
-     *        sets resize and overwrite policies
+     *        sets resize, overwrite, and capacity policies
      *
      *  dynamic_ringbuffer (dynamic_ringbuffer const &):
      *      - copy constructs buffer; copy constructs allocator; copies resize
@@ -189,6 +227,8 @@ namespace
      *              currently allocated storage
      *  - resize:   changes the number of elements stored
      *  - shrink_to_fit: reduces memory usage by freeing unused memory
+     *  - finish_migration: completes any relocation left pending by the
+     *                      incremental resize policy
      *
      *  - get_allocator: returns the allocator associated with the container
      *
@@ -198,11 +238,27 @@ namespace
      *  - set_overwrite_policy: sets the overwrite policy for the container
      *  - get_overwrite_policy: returns the overwrite policy for the container
      *
+     *  - set_capacity_policy: sets the capacity policy for the container
+     *  - get_capacity_policy: returns the capacity policy for the container
+     *
      *  - clear:                clears the contents of the buffer
      *  - push/push_back:       inserts an element at the end
      *  - emplace/emplace_back: constructs an element in-place at the end
      *  - pop/pop_front:        removes the first element
      *
+     *  - push_n: inserts a contiguous run of elements at the end
+     *  - pop_n:  removes up to a given number of elements from the front,
+     *            moving them into a contiguous output range
+     *
+     *  - read_regions:  exposes the occupied storage as at most two
+     *                   contiguous (pointer, length) segments
+     *  - write_regions: exposes the free storage as at most two contiguous
+     *                   (pointer, length) segments
+     *  - commit:  publishes elements placed into the free segments by
+     *             external writes
+     *  - consume: retires elements drained from the occupied segments by
+     *             external reads
+     *
      *  - swap: swaps the contents. Template typename T must be Swappable.
      */
     template <typename T, typename Alloc = std::allocator <memblock <T>>>
@@ -228,7 +284,8 @@ namespace
         enum class resize_policy
         {
             resize = 0,
-            no_resize
+            no_resize,
+            incremental
         };
 
         enum class overwrite_policy
@@ -237,6 +294,12 @@ namespace
             overwrite
         };
 
+        enum class capacity_policy
+        {
+            geometric = 0,
+            power_of_two
+        };
+
         using allocator_type = Alloc;
 
     private:
@@ -312,6 +375,34 @@ namespace
             return r;
         }
 
+        static std::size_t round_up_pow2 (std::size_t n) noexcept
+        {
+            static constexpr std::size_t max_size {
+                std::numeric_limits <std::size_t>::max () / sizeof (T)
+            };
+
+            std::size_t r = 2;
+
+            while (r < n) {
+                if (r > max_size / 2) {
+                    r = max_size;
+                    break;
+                } else {
+                    r <<= 1;
+                }
+            }
+
+            return r;
+        }
+
+        /* rounds a requested capacity according to the capacity policy */
+        std::size_t grow (std::size_t n) const noexcept
+        {
+            return _cappolicy == capacity_policy::power_of_two
+                ? round_up_pow2 (n)
+                : bump_up (n);
+        }
+
         using backing_pointer         = memblock <T> *;
         using backing_const_pointer   = memblock <T> const *;
         using backing_reference       = memblock <T> &;
@@ -323,6 +414,9 @@ namespace
         enum resize_policy _rspolicy;
         enum overwrite_policy _owpolicy;
 
+        /* policy determining how requested capacities are rounded */
+        enum capacity_policy _cappolicy;
+
         /* number of buffered elements */
         std::size_t _buffered;
 
@@ -348,6 +442,23 @@ namespace
         iterator_impl <T> _head;
         iterator_impl <T> _tail;
 
+        /*
+         * incremental migration state: when growth occurs under
+         * resize_policy::incremental the previous allocation is retired
+         * rather than drained on the spot, and its elements are relocated a
+         * bounded number at a time by subsequent operations. logical indices
+         * [_mfront, _mback) of the region being migrated still reside in the
+         * retired buffer, bounded there by the iterators _mhead and _mtail;
+         * the remainder have already been moved into their reserved slots at
+         * the front of the new allocation.
+         */
+        memblock <T> * _mbuffer = nullptr;
+        std::size_t _mcapacity = 0;
+        std::size_t _mfront = 0;
+        std::size_t _mback = 0;
+        iterator_impl <T> _mhead;
+        iterator_impl <T> _mtail;
+
         template <typename U>
         class iterator_impl : public std::iterator <
             std::random_access_iterator_tag, U, std::ptrdiff_t, U *, U &
@@ -419,8 +530,11 @@ namespace
             void swap (iterator_impl & other) noexcept
             {
                 std::swap (this->_iter, other._iter);
-                std::swap (this->_first, other._first);
-                std::swap (this->_last, other._last);
+                std::swap (this->_lfirst, other._lfirst);
+                std::swap (this->_llast, other._llast);
+                std::swap (this->_rfirst, other._rfirst);
+                std::swap (this->_rlast, other._rlast);
+                std::swap (this->_bufsize, other._bufsize);
             }
 
             iterator_impl & operator++ (void)
@@ -486,9 +600,31 @@ namespace
                  *      b. this is below _llast
                  */
 
-                /* case i. */
+                /*
+                 * case i. -- note that the privileged iterators of the
+                 * container have a logical region spanning the whole of the
+                 * backing buffer, and so even in the contiguous case we must
+                 * wrap around the real region boundaries.
+                 */
                 if (this->logical_region_is_contiguous ()) {
-                    _iter += n;
+                    if (n >= 0) {
+                        /* stays in-bounds */
+                        if (_iter + n <= _rlast) {
+                            _iter += n;
+                        /* overflow past-the-end */
+                        } else {
+                            _iter = _rfirst + (n - 1 - (_rlast - _iter));
+                        }
+                    } else {
+                        /* stays in-bounds */
+                        if (_iter + n >= _rfirst) {
+                            _iter += n;
+                        /* underflows before-the-beginning */
+                        } else {
+                            auto const m {-n};
+                            _iter = _rlast - (m - 1 - (_iter - _rfirst));
+                        }
+                    }
                 /* cast ii.a. */
                 } else if (_lfirst <= _iter) {
                     /* stays in-bounds */
@@ -533,7 +669,7 @@ namespace
             difference_type operator- (iterator_impl const & rhs) const
             {
                 /* normal configuration -- non-wraparound case */
-                if (_first < _last) {
+                if (_lfirst < _llast) {
                     return this->_iter - rhs._iter;
                 /*
                  * _last is behind _first (in the address space) --
@@ -661,6 +797,23 @@ namespace
             this->_tail = iterator {
                 nullptr, nullptr, nullptr, nullptr, nullptr
             };
+            this->_mbuffer = nullptr;
+            this->_mcapacity = 0;
+            this->_mfront = 0;
+            this->_mback = 0;
+            this->_mhead = iterator {};
+            this->_mtail = iterator {};
+        }
+
+        /* transfers the migration state of other into this */
+        void adopt_migration (dynamic_ringbuffer & other) noexcept
+        {
+            this->_mbuffer = other._mbuffer;
+            this->_mcapacity = other._mcapacity;
+            this->_mfront = other._mfront;
+            this->_mback = other._mback;
+            this->_mhead = other._mhead;
+            this->_mtail = other._mtail;
         }
 
         using iterator        = iterator_impl <T>;
@@ -680,6 +833,7 @@ namespace
             : _alloc    {}
             , _rspolicy {resize_policy::resize}
             , _owpolicy {overwrite_policy::no_overwrite}
+            , _cappolicy {capacity_policy::geometric}
             , _buffered {0}
             , _capacity {0}
             , _buffer   {nullptr}
@@ -694,6 +848,7 @@ namespace
             : _alloc    {alloc}
             , _rspolicy {resize_policy::resize}
             , _owpolicy {overwrite_policy::no_overwrite}
+            , _cappolicy {capacity_policy::geometric}
             , _buffered {0}
             , _capacity {0}
             , _buffer   {nullptr}
@@ -706,13 +861,15 @@ namespace
         dynamic_ringbuffer (
             size_type count,
             enum resize_policy rspol = resize_policy::resize,
-            enum overwrite_policy owpol = overwrite_policy::no_overwrite
+            enum overwrite_policy owpol = overwrite_policy::no_overwrite,
+            enum capacity_policy cppol = capacity_policy::geometric
         )
             : _alloc    {}
             , _rspolicy {rspol}
             , _owpolicy {owpol}
+            , _cappolicy {cppol}
             , _buffered {0}
-            , _capacity {bump_up (count)}
+            , _capacity {grow (count)}
             , _buffer   {alloc_traits::allocate (_alloc, _capacity)}
         {
             this->set_buffer_pointers ();
@@ -723,13 +880,15 @@ namespace
             size_type count,
             allocator_type const & alloc,
             enum resize_policy rspol = resize_policy {},
-            enum overwrite_policy owpol = overwrite_policy {}
+            enum overwrite_policy owpol = overwrite_policy {},
+            enum capacity_policy cppol = capacity_policy {}
         )
             : _alloc    {alloc}
             , _rspolicy {rspol}
             , _owpolicy {owpol}
+            , _cappolicy {cppol}
             , _buffered {0}
-            , _capacity {bump_up (count)}
+            , _capacity {grow (count)}
             , _buffer   {alloc_traits::allocate (_alloc, _capacity)}
         {
             this->set_buffer_pointers ();
@@ -744,26 +903,14 @@ namespace
             }
             , _rspolicy {other._rspolicy}
             , _owpolicy {other._owpolicy}
-            , _buffered {other._buffered}
+            , _cappolicy {other._cappolicy}
+            , _buffered {0}
             , _capacity {other._capacity}
             , _buffer   {alloc_traits::allocate (_alloc, _capacity)}
         {
             this->set_buffer_pointers ();
             this->set_buffer_iterators ();
-
-            auto ti {this->_tail};
-            auto oi {other.cbegin ()};
-            auto ob {other._buffered};
-
-            while (ob) {
-                auto const addr {ti.addressof ()};
-                new (addr) value_type {*oi};
-                ti += 1;
-                oi += 1;
-                ob -= 1;
-            }
-
-            this->_tail += this->_buffered;
+            this->copy_contents (other);
         }
 
         dynamic_ringbuffer (
@@ -772,26 +919,14 @@ namespace
             : _alloc    {alloc}
             , _rspolicy {other._rspolicy}
             , _owpolicy {other._owpolicy}
-            , _buffered {other._buffered}
+            , _cappolicy {other._cappolicy}
+            , _buffered {0}
             , _capacity {other._capacity}
             , _buffer   {alloc_traits::allocate (_alloc, _capacity)}
         {
             this->set_buffer_pointers ();
             this->set_buffer_iterators ();
-
-            auto ti {this->_tail};
-            auto oi {other.cbegin ()};
-            auto ob {other._buffered};
-
-            while (ob) {
-                auto const addr {ti.addressof ()};
-                new (addr) value_type {*oi};
-                ti += 1;
-                oi += 1;
-                ob -= 1;
-            }
-
-            this->_tail += this->_buffered;
+            this->copy_contents (other);
         }
 
         dynamic_ringbuffer (dynamic_ringbuffer && other)
@@ -799,12 +934,19 @@ namespace
             : _alloc    {std::move (other._alloc)}
             , _rspolicy {other._rspolicy}
             , _owpolicy {other._owpolicy}
+            , _cappolicy {other._cappolicy}
             , _buffered {other._buffered}
             , _capacity {other._capacity}
             , _buffer   {other._buffer}
         {
+            /*
+             * the backing allocation is stolen wholesale, so the head/tail
+             * positions (and any in-progress migration) carry over as-is.
+             */
             this->set_buffer_pointers ();
-            this->set_buffer_iterators ();
+            this->_head = other._head;
+            this->_tail = other._tail;
+            this->adopt_migration (other);
 
             other.reset ();
         }
@@ -815,15 +957,19 @@ namespace
             : _alloc    {alloc}
             , _rspolicy {other._rspolicy}
             , _owpolicy {other._owpolicy}
+            , _cappolicy {other._cappolicy}
             , _buffered {other._buffered}
             , _capacity {other._capacity}
         {
             if (this->_alloc == other._alloc) {
                 this->_buffer = other._buffer;
+                this->set_buffer_pointers ();
                 this->_head = other._head;
                 this->_tail = other._tail;
-                this->set_buffer_iterators ();
+                this->adopt_migration (other);
             } else {
+                other.finish_migration ();
+
                 this->_buffer = alloc_traits::allocate (
                     this->_alloc, this->_capacity
                 );
@@ -845,6 +991,9 @@ namespace
 
                 this->_tail += this->_buffered;
                 other.clear ();
+                alloc_traits::deallocate (
+                    other._alloc, other._buffer, other._capacity
+                );
             }
 
             other.reset ();
@@ -855,6 +1004,7 @@ namespace
             this->clear ();
             this->_rspolicy = other._rspolicy;
             this->_owpolicy = other._owpolicy;
+            this->_cappolicy = other._cappolicy;
 
             if (alloc_propagate_on_container_copy_assignment::value) {
                 if (this->_alloc != other._alloc && this->_buffer != nullptr) {
@@ -889,24 +1039,7 @@ namespace
 
             this->set_buffer_pointers ();
             this->set_buffer_iterators ();
-
-            auto oi {other.cbegin ()};
-            auto ob {other._buffered};
-
-            while (ob) {
-                auto const addr {this->_tail.addressof ()};
-                new (addr) value_type {*oi};
-                oi += 1;
-                ob -= 1;
-
-                /*
-                 * we leave this here in the case that T is not nothrow copy
-                 * constructible, so that in the case of an exception being
-                 * thrown the container remains in a consistent state.
-                 */
-                this->_buffered += 1;
-                this->_tail += 1;
-            }
+            this->copy_contents (other);
 
             return *this;
         }
@@ -925,6 +1058,7 @@ namespace
             this->clear ();
             this->_rspolicy = other._rspolicy;
             this->_owpolicy = other._owpolicy;
+            this->_cappolicy = other._cappolicy;
 
             if (alloc_propagate_on_container_move_assignment::value) {
                 if (this->_buffer != nullptr) {
@@ -940,7 +1074,9 @@ namespace
                 this->_capacity = other._capacity;
                 this->_buffer = other._buffer;
                 this->set_buffer_pointers ();
-                this->set_buffer_iterators ();
+                this->_head = other._head;
+                this->_tail = other._tail;
+                this->adopt_migration (other);
             } else if (this->_alloc == other._alloc) {
                 if (this->_buffer != nullptr) {
                     alloc_traits::deallocate (
@@ -954,8 +1090,12 @@ namespace
                 this->_capacity = other._capacity;
                 this->_buffer = other._buffer;
                 this->set_buffer_pointers ();
-                this->set_buffer_iterators ();
+                this->_head = other._head;
+                this->_tail = other._tail;
+                this->adopt_migration (other);
             } else {
+                other.finish_migration ();
+
                 if (this->_capacity < other._buffered) {
                     if (this->_buffer != nullptr) {
                         alloc_traits::deallocate (
@@ -1008,19 +1148,260 @@ namespace
             p->~value_type ();
         }
 
+        /* bounded number of retired elements relocated per operation */
+        static constexpr std::size_t migration_stride = 2;
+
+        /* releases the retired allocation once nothing resides in it */
+        void release_retired (void) noexcept
+        {
+            alloc_traits::deallocate (
+                this->_alloc, this->_mbuffer, this->_mcapacity
+            );
+            this->_mbuffer = nullptr;
+            this->_mcapacity = 0;
+            this->_mfront = 0;
+            this->_mback = 0;
+        }
+
+        /*
+         * retires the current allocation and installs a larger one; the
+         * elements are not relocated here but lazily, migration_stride of
+         * them per subsequent operation, starting from the back of the
+         * retired region so that pops can keep consuming its front. the
+         * first _buffered slots of the new allocation are reserved as the
+         * migration destinations, and _head skips a reserved slot whenever
+         * the corresponding element is consumed from the retired buffer.
+         */
+        void begin_migration (void)
+        {
+            this->finish_migration ();
+
+            auto const cap {this->grow (this->_capacity + 1)};
+            auto const new_alloc {alloc_traits::allocate (this->_alloc, cap)};
+
+            this->_mbuffer = this->_buffer;
+            this->_mcapacity = this->_capacity;
+            this->_mfront = 0;
+            this->_mback = this->_buffered;
+            this->_mhead = this->_head;
+            this->_mtail = this->_tail;
+
+            this->_buffer = new_alloc;
+            this->_capacity = cap;
+            this->set_buffer_pointers ();
+            this->set_buffer_iterators ();
+            this->_tail += this->_buffered;
+        }
+
+        /*
+         * relocates the last count retired elements into their reserved
+         * slots of the new allocation. when value_type is trivially
+         * relocatable the elements are copied as at most two calls to
+         * std::memcpy (the retired region may wrap) and the sources are
+         * abandoned without running destructors; otherwise each element is
+         * move constructed and destroyed in place.
+         */
+        void relocate_retired_ (std::size_t count, std::true_type) noexcept
+        {
+            auto src {this->_mtail};
+            src -= static_cast <difference_type> (count);
+
+            auto const obase {reinterpret_cast <pointer> (this->_mbuffer)};
+            auto const base {reinterpret_cast <pointer> (this->_first)};
+            auto const sp {src.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                obase + this->_mcapacity - sp
+            )};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            this->_mback -= count;
+            std::memcpy (
+                static_cast <void *> (base + this->_mback),
+                sp,
+                first_segment * sizeof (value_type)
+            );
+
+            if (count > first_segment) {
+                std::memcpy (
+                    static_cast <void *> (
+                        base + this->_mback + first_segment
+                    ),
+                    obase,
+                    (count - first_segment) * sizeof (value_type)
+                );
+            }
+
+            this->_mtail = src;
+        }
+
+        void relocate_retired_ (std::size_t count, std::false_type)
+        {
+            auto const base {reinterpret_cast <pointer> (this->_first)};
+
+            while (count) {
+                this->_mtail -= 1;
+                this->_mback -= 1;
+                new (base + this->_mback) value_type {
+                    std::move (*this->_mtail)
+                };
+                destruct (this->_mtail.addressof ());
+                count -= 1;
+            }
+        }
+
+        /*
+         * relocates the buffered contents, beginning at _head, into the
+         * fresh contiguous storage at dst; under trivial relocatability
+         * this is at most two calls to std::memcpy over the ring's
+         * occupied segments, with the sources abandoned without running
+         * destructors. the caller installs dst as the new backing buffer.
+         */
+        void relocate_buffered_ (pointer dst, std::true_type) noexcept
+        {
+            auto const count {this->_buffered};
+            if (count == 0) {
+                return;
+            }
+
+            auto const src {this->_head.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (this->_last) - src
+            ) + 1};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            std::memcpy (
+                static_cast <void *> (dst),
+                src,
+                first_segment * sizeof (value_type)
+            );
+
+            if (count > first_segment) {
+                std::memcpy (
+                    static_cast <void *> (dst + first_segment),
+                    reinterpret_cast <pointer> (this->_first),
+                    (count - first_segment) * sizeof (value_type)
+                );
+            }
+        }
+
+        void relocate_buffered_ (pointer dst, std::false_type)
+        {
+            auto it {this->_head};
+            auto b {this->_buffered};
+
+            while (b) {
+                new (dst) value_type {std::move (*it)};
+                destruct (it.addressof ());
+                dst += 1;
+                it += 1;
+                b -= 1;
+            }
+        }
+
+        /* relocates at most migration_stride retired elements */
+        void migrate_step (void)
+        {
+            if (this->_mbuffer == nullptr) {
+                return;
+            }
+
+            auto const pending {this->_mback - this->_mfront};
+            auto const count {
+                pending < migration_stride ? pending : migration_stride
+            };
+
+            if (count) {
+                this->relocate_retired_ (
+                    count, is_trivially_relocatable <value_type> {}
+                );
+            }
+
+            if (this->_mback == this->_mfront) {
+                this->release_retired ();
+            }
+        }
+
+        /*
+         * copy constructs the logical contents of other at the tail of this
+         * buffer; the retired region of a migrating source is walked first,
+         * since its elements logically precede everything in the source's
+         * current allocation.
+         */
+        void copy_contents (dynamic_ringbuffer const & other)
+        {
+            auto const retired {
+                other._mbuffer != nullptr
+                    ? other._mback - other._mfront
+                    : std::size_t {0}
+            };
+
+            auto mi {other._mhead};
+            auto mb {retired};
+
+            while (mb) {
+                auto const addr {this->_tail.addressof ()};
+                new (addr) value_type {*mi};
+                mi += 1;
+                mb -= 1;
+
+                /*
+                 * we leave this here in the case that T is not nothrow copy
+                 * constructible, so that in the case of an exception being
+                 * thrown the container remains in a consistent state.
+                 */
+                this->_buffered += 1;
+                this->_tail += 1;
+            }
+
+            auto oi {other.cbegin ()};
+            oi += static_cast <difference_type> (retired);
+            auto ob {other._buffered - retired};
+
+            while (ob) {
+                auto const addr {this->_tail.addressof ()};
+                new (addr) value_type {*oi};
+                oi += 1;
+                ob -= 1;
+                this->_buffered += 1;
+                this->_tail += 1;
+            }
+        }
+
     public:
+        /*
+         * completes any in-progress incremental migration, relocating every
+         * element still residing in the retired allocation and releasing it.
+         * operations that must view the contents as a single logical region
+         * (reserve, resize, swap, the bulk push_n/pop_n, and the like) call
+         * this implicitly; latency-sensitive callers may invoke it directly
+         * at a convenient moment instead.
+         */
+        void finish_migration (void)
+        {
+            if (this->_mbuffer == nullptr) {
+                return;
+            }
+
+            if (this->_mback > this->_mfront) {
+                this->relocate_retired_ (
+                    this->_mback - this->_mfront,
+                    is_trivially_relocatable <value_type> {}
+                );
+            }
+
+            this->release_retired ();
+        }
+
         ~dynamic_ringbuffer (void)
             noexcept (std::is_nothrow_destructible <value_type>::value)
         {
-            if (this->_buffer) {
-                auto it {this->end ()};
-
-                while (_buffered > 0) {
-                    it -= 1;
-                    _buffered -= 1;
-                    destruct (it.addressof ());
-                }
+            this->clear ();
 
+            if (this->_buffer) {
                 alloc_traits::deallocate (
                     this->_alloc, this->_buffer, this->_capacity
                 );
@@ -1045,10 +1426,17 @@ namespace
             std::swap (this->_capacity, other._capacity);
             std::swap (this->_rspolicy, other._rspolicy);
             std::swap (this->_owpolicy, other._owpolicy);
+            std::swap (this->_cappolicy, other._cappolicy);
             std::swap (this->_first, other._first);
             std::swap (this->_last, other._last);
             std::swap (this->_head, other._head);
             std::swap (this->_tail, other._tail);
+            std::swap (this->_mbuffer, other._mbuffer);
+            std::swap (this->_mcapacity, other._mcapacity);
+            std::swap (this->_mfront, other._mfront);
+            std::swap (this->_mback, other._mback);
+            std::swap (this->_mhead, other._mhead);
+            std::swap (this->_mtail, other._mtail);
         }
 
         /* returns the allocator associated with the container */
@@ -1060,7 +1448,7 @@ namespace
         /* checks whether the buffer is empty */
         bool empty (void) const noexcept
         {
-            return _buffered != 0;
+            return _buffered == 0;
         }
 
         /* returns the number of elements stored in the buffer */
@@ -1094,26 +1482,23 @@ namespace
         /* reserves storage large enough to store at least new_cap elements */
         void reserve (std::size_t new_cap)
         {
+            this->finish_migration ();
+
             if (new_cap > _capacity) {
                 if (new_cap > this->max_size ()) {
                     throw std::length_error {
                         "requested reserve of capacity larger than maximum size"
                     };
                 } else {
-                    auto const cap {bump_up (new_cap)};
+                    auto const cap {this->grow (new_cap)};
                     auto const new_alloc {
                         alloc_traits::allocate (this->_alloc, cap)
                     };
 
-                    {
-                        auto insert_ptr {
-                            reinterpret_cast <pointer> (new_alloc)
-                        };
-                        for (auto & e : *this) {
-                            new (insert_ptr) value_type {std::move (e)};
-                            insert_ptr += 1;
-                        }
-                    }
+                    this->relocate_buffered_ (
+                        reinterpret_cast <pointer> (new_alloc),
+                        is_trivially_relocatable <value_type> {}
+                    );
 
                     if (this->_buffer != nullptr) {
                         alloc_traits::deallocate (
@@ -1127,6 +1512,7 @@ namespace
                     this->_buffer = new_alloc;
                     this->set_buffer_pointers ();
                     this->set_buffer_iterators ();
+                    this->_tail += this->_buffered;
                 }
             }
         }
@@ -1141,6 +1527,8 @@ namespace
          */
         void resize (std::size_t count)
         {
+            this->finish_migration ();
+
             if (count == 0) {
                 this->clear ();
             } else {
@@ -1175,6 +1563,8 @@ namespace
          */
         void resize (std::size_t count, value_type const & value)
         {
+            this->finish_migration ();
+
             if (count == 0) {
                 this->clear ();
             } else {
@@ -1202,19 +1592,18 @@ namespace
         /* requests the removal of unused capacity */
         void shrink_to_fit (void)
         {
-            auto const bu {bump_up (_buffered)};
+            this->finish_migration ();
+
+            auto const bu {this->grow (_buffered)};
             if (bu < _capacity) {
                 auto const new_alloc {
                     alloc_traits::allocate (this->_alloc, bu)
                 };
 
-                {
-                    auto insert_ptr {reinterpret_cast <pointer> (new_alloc)};
-                    for (auto & e : *this) {
-                        new (insert_ptr) value_type {std::move (e)};
-                        insert_ptr += 1;
-                    }
-                }
+                this->relocate_buffered_ (
+                    reinterpret_cast <pointer> (new_alloc),
+                    is_trivially_relocatable <value_type> {}
+                );
 
                 if (this->_buffer != nullptr) {
                     alloc_traits::deallocate (
@@ -1228,6 +1617,7 @@ namespace
                 this->_buffer = new_alloc;
                 this->set_buffer_pointers ();
                 this->set_buffer_iterators ();
+                this->_tail += this->_buffered;
             }
         }
 
@@ -1255,6 +1645,21 @@ namespace
             return this->_owpolicy;
         }
 
+        /*
+         * set the capacity policy for the buffer; the policy applies to
+         * subsequent allocations and does not reshape the current storage
+         */
+        void set_capacity_policy (enum capacity_policy pol) noexcept
+        {
+            this->_cappolicy = pol;
+        }
+
+        /* returns the capacity policy for the buffer */
+        enum capacity_policy get_capacity_policy (void) const noexcept
+        {
+            return this->_cappolicy;
+        }
+
     private:
         /* returns an iterator the start of the buffer */
         iterator begin (void) noexcept
@@ -1324,25 +1729,37 @@ namespace
         /* returns a reference to the first element in the buffer */
         reference front (void) noexcept
         {
-            return *_head;
+            return _mbuffer != nullptr && _mfront < _mback
+                ? *_mhead
+                : *_head;
         }
 
         /* returns a reference to the first element in the buffer */
         const_reference front (void) const noexcept
         {
-            return *_head;
+            return _mbuffer != nullptr && _mfront < _mback
+                ? *_mhead
+                : *_head;
         }
 
         /* returns a reference to the last element in the buffer */
         reference back (void) noexcept
         {
-            return _tail == _head ? _tail [0] : _tail [-1];
+            /*
+             * _tail == _head cannot distinguish a full buffer from an
+             * empty one, so the occupancy count decides the case.
+             */
+            return _buffered == 0 ? _tail [0] : _tail [-1];
         }
 
         /* returns a reference to the last element in the buffer */
         const_reference back (void) const noexcept
         {
-            return _tail == _head ? _tail [0] : _tail [-1];
+            /*
+             * _tail == _head cannot distinguish a full buffer from an
+             * empty one, so the occupancy count decides the case.
+             */
+            return _buffered == 0 ? _tail [0] : _tail [-1];
         }
 
         /*
@@ -1352,14 +1769,31 @@ namespace
         void clear (void)
             noexcept (std::is_nothrow_destructible <value_type>::value)
         {
+            /* contents of the current allocation, newest first */
             auto it {_tail};
+            auto live {
+                _buffered - (_mbuffer != nullptr ? _mback - _mfront : 0)
+            };
 
-            while (_buffered > 0) {
+            while (live > 0) {
                 it -= 1;
+                live -= 1;
                 _buffered -= 1;
                 destruct (it.addressof ());
             }
 
+            /* contents still residing in the retired allocation */
+            if (_mbuffer != nullptr) {
+                while (_mback > _mfront) {
+                    _mtail -= 1;
+                    _mback -= 1;
+                    _buffered -= 1;
+                    destruct (_mtail.addressof ());
+                }
+
+                this->release_retired ();
+            }
+
             _tail = _head;
         }
 
@@ -1380,13 +1814,21 @@ namespace
                 new (addr) value_type {v};
                 _tail += 1;
                 _buffered += 1;
+                this->migrate_step ();
             } else {
                 if (_rspolicy == resize_policy::resize) {
-                    this->reserve (bump_up (_capacity));
+                    this->reserve (_capacity + 1);
+                    auto const addr {_tail.addressof ()};
+                    new (addr) value_type {v};
+                    _tail += 1;
+                    _buffered += 1;
+                } else if (_rspolicy == resize_policy::incremental) {
+                    this->begin_migration ();
                     auto const addr {_tail.addressof ()};
                     new (addr) value_type {v};
                     _tail += 1;
                     _buffered += 1;
+                    this->migrate_step ();
                 } else if (_owpolicy == overwrite_policy::overwrite) {
                     auto const addr {_tail.addressof ()};
                     destruct (addr);
@@ -1416,13 +1858,21 @@ namespace
                 new (addr) value_type {std::move (v)};
                 _tail += 1;
                 _buffered += 1;
+                this->migrate_step ();
             } else {
                 if (_rspolicy == resize_policy::resize) {
-                    this->reserve (bump_up (_capacity));
+                    this->reserve (_capacity + 1);
+                    auto const addr {_tail.addressof ()};
+                    new (addr) value_type {std::move (v)};
+                    _tail += 1;
+                    _buffered += 1;
+                } else if (_rspolicy == resize_policy::incremental) {
+                    this->begin_migration ();
                     auto const addr {_tail.addressof ()};
                     new (addr) value_type {std::move (v)};
                     _tail += 1;
                     _buffered += 1;
+                    this->migrate_step ();
                 } else if (_owpolicy == overwrite_policy::overwrite) {
                     auto const addr {_tail.addressof ()};
                     destruct (addr);
@@ -1464,13 +1914,21 @@ namespace
                 new (addr) value_type {std::forward <Args> (args)...};
                 _tail += 1;
                 _buffered += 1;
+                this->migrate_step ();
             } else {
                 if (_rspolicy == resize_policy::resize) {
-                    this->reserve (bump_up (_capacity));
+                    this->reserve (_capacity + 1);
                     auto const addr {_tail.addressof ()};
                     new (addr) value_type {std::forward <Args> (args)...};
                     _tail += 1;
                     _buffered += 1;
+                } else if (_rspolicy == resize_policy::incremental) {
+                    this->begin_migration ();
+                    auto const addr {_tail.addressof ()};
+                    new (addr) value_type {std::forward <Args> (args)...};
+                    _tail += 1;
+                    _buffered += 1;
+                    this->migrate_step ();
                 } else if (_owpolicy == overwrite_policy::overwrite) {
                     auto const addr {_tail.addressof ()};
                     destruct (addr);
@@ -1497,10 +1955,361 @@ namespace
             noexcept (std::is_nothrow_destructible <value_type>::value)
         {
             if (_buffered > 0) {
+                if (_mbuffer != nullptr && _mfront < _mback) {
+                    /*
+                     * the logical front still resides in the retired buffer;
+                     * consuming it also kills its reserved destination slot.
+                     */
+                    destruct (_mhead.addressof ());
+                    _mhead += 1;
+                    _mfront += 1;
+                    _head += 1;
+                    _buffered -= 1;
+
+                    if (_mfront == _mback) {
+                        this->release_retired ();
+                    }
+                } else {
+                    destruct (_head.addressof ());
+                    _head += 1;
+                    _buffered -= 1;
+                }
+            }
+        }
+
+    private:
+        /*
+         * bulk writes and reads decompose the logical region into its at most
+         * two contiguous segments up front, so that trivially copyable types
+         * degrade to at most two calls to std::memcpy over the backing buffer
+         * rather than per-element construction.
+         */
+        void push_n_impl (const_pointer src,
+                          std::size_t count,
+                          std::true_type) noexcept
+        {
+            auto const dst {_tail.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (_last) - dst
+            ) + 1};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            std::memcpy (
+                static_cast <void *> (dst),
+                src,
+                first_segment * sizeof (value_type)
+            );
+
+            if (count > first_segment) {
+                std::memcpy (
+                    static_cast <void *> (reinterpret_cast <pointer> (_first)),
+                    src + first_segment,
+                    (count - first_segment) * sizeof (value_type)
+                );
+            }
+
+            _tail += static_cast <difference_type> (count);
+            _buffered += count;
+        }
+
+        void push_n_impl (const_pointer src,
+                          std::size_t count,
+                          std::false_type)
+        {
+            while (count) {
+                auto const addr {_tail.addressof ()};
+                new (addr) value_type {*src};
+                src += 1;
+                count -= 1;
+
+                /*
+                 * we leave this here in the case that T is not nothrow copy
+                 * constructible, so that in the case of an exception being
+                 * thrown the container remains in a consistent state.
+                 */
+                _buffered += 1;
+                _tail += 1;
+            }
+        }
+
+        void pop_n_impl (pointer out,
+                         std::size_t count,
+                         std::true_type) noexcept
+        {
+            auto const src {_head.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (_last) - src
+            ) + 1};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            std::memcpy (
+                static_cast <void *> (out),
+                src,
+                first_segment * sizeof (value_type)
+            );
+
+            if (count > first_segment) {
+                std::memcpy (
+                    static_cast <void *> (out + first_segment),
+                    reinterpret_cast <pointer> (_first),
+                    (count - first_segment) * sizeof (value_type)
+                );
+            }
+
+            _head += static_cast <difference_type> (count);
+            _buffered -= count;
+        }
+
+        void pop_n_impl (pointer out,
+                         std::size_t count,
+                         std::false_type)
+            noexcept (
+                std::is_nothrow_move_assignable <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            while (count) {
+                auto const addr {_head.addressof ()};
+                *out = std::move (*addr);
+                destruct (addr);
+                out += 1;
+                count -= 1;
+                _head += 1;
+                _buffered -= 1;
+            }
+        }
+
+    public:
+        /*
+         * Adds a contiguous run of count objects to the buffer.
+         *
+         * If fewer than count spaces are available, then:
+         *      If the resize policy is set to resize, the internal buffer is
+         *      reallocated with capacity sufficient to hold the run.
+         *
+         *      Otherwise, if the overwrite policy is set to no_overwrite this
+         *      method throws an exception of type std::runtime_error and the
+         *      buffer is left unmodified.
+         *
+         *      Otherwise, this method overwrites as many elements at the
+         *      front of the buffer as are required to make room; if count
+         *      exceeds the capacity of the buffer then only the last
+         *      capacity () objects of the run are buffered.
+         */
+        void push_n (const_pointer src, std::size_t count)
+        {
+            this->finish_migration ();
+
+            if (count > this->available ()) {
+                if (_rspolicy != resize_policy::no_resize) {
+                    this->reserve (_buffered + count);
+                } else if (_owpolicy == overwrite_policy::overwrite) {
+                    if (count > _capacity) {
+                        src += count - _capacity;
+                        count = _capacity;
+                    }
+
+                    auto drop {count - this->available ()};
+
+                    while (drop) {
+                        destruct (_head.addressof ());
+                        _head += 1;
+                        _buffered -= 1;
+                        drop -= 1;
+                    }
+                } else {
+                    throw std::runtime_error {"push_n on full buffer"};
+                }
+            }
+
+            if (count > 0) {
+                this->push_n_impl (
+                    src, count, std::is_trivially_copyable <value_type> {}
+                );
+            }
+        }
+
+        /*
+         * Moves up to count elements from the front of the buffer into the
+         * contiguous range beginning at out; returns the number of elements
+         * removed, which is the smaller of count and size ().
+         */
+        std::size_t pop_n (pointer out, std::size_t count)
+            noexcept (
+                std::is_nothrow_move_constructible <value_type>::value &&
+                std::is_nothrow_move_assignable <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            this->finish_migration ();
+
+            if (count > _buffered) {
+                count = _buffered;
+            }
+
+            if (count > 0) {
+                this->pop_n_impl (
+                    out, count, std::is_trivially_copyable <value_type> {}
+                );
+            }
+
+            return count;
+        }
+
+        /*
+         * contiguous views of buffer storage for scatter-gather I/O; see
+         * read_regions and write_regions below.
+         */
+        struct segment
+        {
+            pointer data;
+            std::size_t length;
+        };
+
+        struct const_segment
+        {
+            const_pointer data;
+            std::size_t length;
+        };
+
+        /*
+         * Fills segs with the occupied storage as at most two contiguous
+         * segments in logical (oldest first) order and returns the number of
+         * nonempty segments. Together with consume, this permits gather I/O
+         * (e.g. writev) directly out of the buffer with no staging copy.
+         *
+         * Any relocation left pending by the incremental resize policy is
+         * completed first, so that the occupied storage is guaranteed to
+         * reside in a single allocation.
+         */
+        std::size_t read_regions (const_segment (& segs) [2])
+        {
+            this->finish_migration ();
+
+            if (_buffered == 0) {
+                segs [0] = const_segment {nullptr, 0};
+                segs [1] = const_segment {nullptr, 0};
+                return 0;
+            }
+
+            auto const head {_head.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <const_pointer> (_last) - head
+            ) + 1};
+            auto const first_segment {
+                _buffered < contiguous ? _buffered : contiguous
+            };
+
+            segs [0] = const_segment {head, first_segment};
+            segs [1] = const_segment {
+                reinterpret_cast <const_pointer> (_first),
+                _buffered - first_segment
+            };
+
+            return segs [1].length ? 2 : 1;
+        }
+
+        /*
+         * Fills segs with the free storage as at most two contiguous
+         * segments in write order and returns the number of nonempty
+         * segments. Together with commit, this permits scatter I/O (e.g.
+         * readv) directly into the buffer with no staging copy; external
+         * writes can only produce trivially copyable objects.
+         *
+         * Any relocation left pending by the incremental resize policy is
+         * completed first, so that the free storage is guaranteed to reside
+         * in a single allocation.
+         */
+        std::size_t write_regions (segment (& segs) [2])
+        {
+            static_assert (
+                std::is_trivially_copyable <value_type>::value,
+                "scatter I/O into the buffer requires a trivially copyable"
+                " value type"
+            );
+
+            this->finish_migration ();
+
+            auto const avail {this->available ()};
+
+            if (avail == 0) {
+                segs [0] = segment {nullptr, 0};
+                segs [1] = segment {nullptr, 0};
+                return 0;
+            }
+
+            auto const tail {_tail.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (_last) - tail
+            ) + 1};
+            auto const first_segment {
+                avail < contiguous ? avail : contiguous
+            };
+
+            segs [0] = segment {tail, first_segment};
+            segs [1] = segment {
+                reinterpret_cast <pointer> (_first),
+                avail - first_segment
+            };
+
+            return segs [1].length ? 2 : 1;
+        }
+
+        /*
+         * Publishes count elements that external writes have placed into the
+         * storage returned by write_regions, advancing the write position.
+         * Throws an exception of type std::runtime_error if count exceeds
+         * the free capacity.
+         */
+        void commit (std::size_t count)
+        {
+            static_assert (
+                std::is_trivially_copyable <value_type>::value,
+                "scatter I/O into the buffer requires a trivially copyable"
+                " value type"
+            );
+
+            this->finish_migration ();
+
+            if (count > this->available ()) {
+                throw std::runtime_error {"commit beyond free capacity"};
+            }
+
+            _tail += static_cast <difference_type> (count);
+            _buffered += count;
+        }
+
+        /*
+         * Retires up to count elements that external reads have drained from
+         * the storage returned by read_regions, advancing the read position;
+         * returns the number of elements retired.
+         */
+        std::size_t consume (std::size_t count)
+            noexcept (
+                std::is_nothrow_move_constructible <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            this->finish_migration ();
+
+            if (count > _buffered) {
+                count = _buffered;
+            }
+
+            auto remaining {count};
+
+            while (remaining) {
                 destruct (_head.addressof ());
                 _head += 1;
                 _buffered -= 1;
+                remaining -= 1;
             }
+
+            return count;
         }
     };
 }   // namespace dsa
@@ -0,0 +1,393 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (kway_merge.hpp) is part of the dsa project.
+//
+// A description of loser (tournament) trees can be found here:
+//
+//      https://en.wikipedia.org/wiki/K-way_merge_algorithm
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/dsa.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_KWAY_MERGE_HPP
+#define DSA_KWAY_MERGE_HPP
+
+#include <cassert>      // assert
+#include <cstddef>      // std::size_t
+#include <functional>   // std::less
+#include <iterator>     // std::iterator_traits
+#include <utility>      // std::pair, std::swap
+#include <vector>       // std::vector
+
+
+namespace dsa
+{
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::kway_merger <> merges N sorted input ranges into one sorted
+     * output stream using a loser (tournament) tree: the current heads of
+     * all sources are held as the leaves of an implicit complete binary
+     * tree stored in a flat array, each internal node records the loser of
+     * the match played there, and emitting an element replays only the
+     * winner's path, costing ceil(log2 N) comparisons per element with no
+     * pointer chasing. Ties between sources are won by the lower source
+     * index, so the merge is stable with respect to run order.
+     *
+     * Sources come in two kinds. A run (add_run) is a finite sorted range
+     * that is consumed to completion. A stream (add_stream) is a sorted
+     * range backed by staged I/O — for instance the readable region of a
+     * ringbuffer being refilled from disk: when a stream's range empties
+     * the merge stalls, starved () names the stream, and the producer
+     * re-arms it with refill () or retires it with finish (). The merge
+     * never emits while an open stream is empty, since its next element
+     * could precede every buffered one; each refill must itself be sorted
+     * and begin no earlier than the last element taken from that stream.
+     *
+     * merge_n bounds the number of elements emitted per call, so output
+     * can be staged through a fixed buffer (e.g. a ringbuffer write
+     * region) and refills amortized over whole batches rather than paid
+     * per element.
+     *
+     * Template Parameters
+     * -------------------
+     * - InputIt: the iterator type of the source ranges; it is read one
+     *   element ahead, so forward iterators suffice.
+     *
+     * - Compare: the strict weak ordering the input ranges are sorted by.
+     *
+     * Member Functions
+     * ----------------
+     *      - add_run/add_stream
+     *      - refill/finish
+     *      - merge/merge_n
+     *      - starved/exhausted
+     *      - sources
+     */
+    template <
+        typename InputIt,
+        typename Compare = std::less <
+            typename std::iterator_traits <InputIt>::value_type
+        >
+    >
+    class kway_merger
+    {
+    public:
+        using iterator    = InputIt;
+        using value_type  = typename std::iterator_traits <InputIt>::value_type;
+        using size_type   = std::size_t;
+        using key_compare = Compare;
+
+        static constexpr size_type npos = static_cast <size_type> (-1);
+
+        explicit kway_merger (Compare comp = Compare {})
+            : _sources {}
+            , _tree    {}
+            , _comp    {comp}
+            , _leaves  {0}
+            , _dry     {0}
+            , _built   {false}
+        {}
+
+        /* adds a finite sorted range, consumed to completion */
+        void add_run (InputIt first, InputIt last)
+        {
+            this->add_source (first, last, false);
+        }
+
+        /* adds a refillable sorted source; see refill and finish */
+        void add_stream (InputIt first, InputIt last)
+        {
+            this->add_source (first, last, true);
+        }
+
+        /*
+         * re-arms the stream at index with its next staged range; the new
+         * range must be sorted and begin no earlier than the last element
+         * taken from this stream.
+         */
+        void refill (size_type index, InputIt first, InputIt last)
+        {
+            auto & s = this->_sources [index];
+            assert (s.open && s.pos == s.last);
+
+            s.pos = first;
+            s.last = last;
+
+            if (first != last) {
+                this->_dry -= 1;
+            }
+
+            this->_built = false;
+        }
+
+        /* marks the stream at index as having no further data */
+        void finish (size_type index)
+        {
+            auto & s = this->_sources [index];
+            assert (s.open);
+
+            if (s.pos == s.last) {
+                this->_dry -= 1;
+            }
+
+            s.open = false;
+            this->_built = false;
+        }
+
+        /*
+         * the index of an open stream whose staged range is empty, or
+         * npos; while one exists the merge cannot safely emit and every
+         * such stream must be refilled or finished.
+         */
+        size_type starved (void) const noexcept
+        {
+            if (this->_dry > 0) {
+                for (size_type s = 0; s < this->_sources.size (); ++s) {
+                    if (this->_sources [s].open &&
+                        this->_sources [s].pos == this->_sources [s].last)
+                    {
+                        return s;
+                    }
+                }
+            }
+
+            return npos;
+        }
+
+        /* true once every run is consumed and every stream finished */
+        bool exhausted (void) const noexcept
+        {
+            for (auto const & s : this->_sources) {
+                if (s.open || s.pos != s.last) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        size_type sources (void) const noexcept
+        {
+            return this->_sources.size ();
+        }
+
+        /*
+         * emits at most limit elements; stops early when every source is
+         * drained or an open stream starves. Returns the advanced output
+         * iterator.
+         */
+        template <typename OutputIt>
+        OutputIt merge_n (OutputIt out, size_type limit)
+        {
+            if (!this->_built) {
+                this->build ();
+            }
+
+            while (limit != 0 && this->_dry == 0) {
+                auto const w = this->_tree [0];
+                if (w == npos) {
+                    break;
+                }
+
+                auto & s = this->_sources [w];
+                if (s.pos == s.last) {
+                    /* only drained sources remain in the tournament */
+                    break;
+                }
+
+                *out = *s.pos;
+                ++out;
+                ++s.pos;
+                limit -= 1;
+
+                if (s.pos == s.last && s.open) {
+                    this->_dry += 1;
+                }
+
+                this->replay (w);
+            }
+
+            return out;
+        }
+
+        /* drains every source; with open streams, stops at starvation */
+        template <typename OutputIt>
+        OutputIt merge (OutputIt out)
+        {
+            return this->merge_n (out, npos);
+        }
+
+    private:
+        struct source
+        {
+            InputIt pos;
+            InputIt last;
+            bool open;
+        };
+
+        void add_source (InputIt first, InputIt last, bool open)
+        {
+            this->_sources.push_back (source {first, last, open});
+
+            if (open && first == last) {
+                this->_dry += 1;
+            }
+
+            this->_built = false;
+        }
+
+        /*
+         * whether source a's head precedes source b's in the tournament;
+         * drained sources and the npos sentinel lose to everything, and
+         * ties fall to the lower index for stability.
+         */
+        bool ranks_before (size_type a, size_type b) const
+        {
+            if (b == npos) {
+                return true;
+            }
+            if (a == npos) {
+                return false;
+            }
+
+            auto const & sa = this->_sources [a];
+            auto const & sb = this->_sources [b];
+
+            if (sa.pos == sa.last) {
+                return false;
+            }
+            if (sb.pos == sb.last) {
+                return true;
+            }
+            if (this->_comp (*sa.pos, *sb.pos)) {
+                return true;
+            }
+            if (this->_comp (*sb.pos, *sa.pos)) {
+                return false;
+            }
+
+            return a < b;
+        }
+
+        /*
+         * rebuilds the tournament bottom-up in O(N). The source count is
+         * padded to a power of two so every leaf sits at the same depth;
+         * the padding leaves hold the npos sentinel and never win.
+         */
+        void build (void)
+        {
+            this->_leaves = 1;
+            while (this->_leaves < this->_sources.size ()) {
+                this->_leaves *= 2;
+            }
+
+            this->_tree.assign (this->_leaves, npos);
+
+            /* winners [node] is the winner of the subtree under node; the
+             * loser of each match is what _tree records */
+            std::vector <size_type> winners (2 * this->_leaves, npos);
+            for (size_type s = 0; s < this->_sources.size (); ++s) {
+                winners [this->_leaves + s] = s;
+            }
+
+            for (auto node = this->_leaves - 1; node >= 1; --node) {
+                auto a = winners [2 * node];
+                auto b = winners [2 * node + 1];
+
+                if (this->ranks_before (b, a)) {
+                    std::swap (a, b);
+                }
+
+                winners [node] = a;
+                this->_tree [node] = b;
+            }
+
+            this->_tree [0] = winners [1];
+            this->_built = true;
+        }
+
+        /*
+         * replays the matches along the previous winner's path after its
+         * head advanced; every opponent it must face again is recorded on
+         * exactly that path.
+         */
+        void replay (size_type s)
+        {
+            auto winner = s;
+            for (auto node = (this->_leaves + s) / 2; node >= 1; node /= 2) {
+                if (this->ranks_before (this->_tree [node], winner)) {
+                    std::swap (winner, this->_tree [node]);
+                }
+            }
+
+            this->_tree [0] = winner;
+        }
+
+        std::vector <source> _sources;
+        std::vector <size_type> _tree;
+        key_compare _comp;
+        size_type _leaves;
+        size_type _dry;
+        bool _built;
+    };
+
+    /*
+     * out-of-line definition; required in C++11, where the in-class
+     * initializer alone is not a definition and npos is odr-used wherever
+     * it binds to a reference parameter.
+     */
+    template <typename InputIt, typename Compare>
+    constexpr typename kway_merger <InputIt, Compare>::size_type
+        kway_merger <InputIt, Compare>::npos;
+
+    /*
+     * merges the sorted runs designated by the iterator-pair range
+     * [first_run, last_run) into out, returning the advanced output
+     * iterator; equivalent to repeated std::merge but with one
+     * tournament-tree pass over all runs.
+     */
+    template <typename RunIt, typename OutputIt, typename Compare>
+    OutputIt kway_merge (RunIt first_run, RunIt last_run,
+                         OutputIt out, Compare comp)
+    {
+        using run_type = typename std::iterator_traits <RunIt>::value_type;
+        using input_iterator = typename run_type::first_type;
+
+        kway_merger <input_iterator, Compare> merger {comp};
+        for (; first_run != last_run; ++first_run) {
+            merger.add_run (first_run->first, first_run->second);
+        }
+
+        return merger.merge (out);
+    }
+
+    template <typename RunIt, typename OutputIt>
+    OutputIt kway_merge (RunIt first_run, RunIt last_run, OutputIt out)
+    {
+        using run_type = typename std::iterator_traits <RunIt>::value_type;
+        using input_iterator = typename run_type::first_type;
+        using value_type =
+            typename std::iterator_traits <input_iterator>::value_type;
+
+        return kway_merge (
+            first_run, last_run, out, std::less <value_type> {}
+        );
+    }
+}   // namespace dsa
+
+#endif  // #ifndef DSA_KWAY_MERGE_HPP
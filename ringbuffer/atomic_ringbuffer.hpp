@@ -0,0 +1,325 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (atomic_ringbuffer.hpp) is part of the dsa project.
+//
+// atomic_ringbuffer; a fixed-size, lock-free single-producer/single-consumer
+// circular buffer for C++11 and later.
+//
+// A description of the circular buffer data structure can be found here:
+//
+//      https://en.wikipedia.org/wiki/Circular_buffer
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/atomic_ringbuffer.git
+// license:
+//
+// Copyright (c) 2016 DaltonWoodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_ATOMIC_RINGBUFFER_HPP
+#define DSA_ATOMIC_RINGBUFFER_HPP
+
+#include <array>        // std::array
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <new>          // placement new
+#include <type_traits>  // std::is_nothrow_destructible,
+                        // std::is_nothrow_move_assignable
+#include <utility>      // std::forward, std::move
+
+
+namespace dsa
+{
+namespace
+{
+    template <typename T>
+    struct memblock
+    {
+        alignas (alignof (T)) unsigned char data [sizeof (T)];
+    };
+}   // annonymous namespace
+
+    /*
+     *  Description
+     *  -----------
+     *
+     *  dsa::atomic_ringbuffer <> is a fixed-size circular buffer safe for
+     *  concurrent use by exactly one producer thread and exactly one consumer
+     *  thread, with no locks and no waiting on either side.
+     *
+     *  The producer owns the write index and the consumer owns the read
+     *  index; each index is modified by its owning thread only and published
+     *  to the other side with release stores paired with acquire loads, so
+     *  an element is always fully constructed before the consumer can
+     *  observe it (and fully destructed before the producer can reuse its
+     *  slot). Both indices are padded to separate cache lines to avoid the
+     *  false sharing that otherwise arises between the two threads.
+     *
+     *  Unlike dsa::ringbuffer, write and read operations do not throw on
+     *  exhaustion and there is no overwrite policy: push/emplace return
+     *  false when the buffer is full, and pop returns false when it is
+     *  empty, leaving progress decisions (retry, drop, back off) to the
+     *  caller, which is invariably what a real-time producer/consumer
+     *  pipeline wants.
+     *
+     *  Template Parameters
+     *  -------------------
+     *  - T: the object type to be buffered. This type does *not* have to be
+     *  default constructable.
+     *
+     *  - N: the maximum number of elements for the buffer to hold; the
+     *  number N must be nonzero.
+     *
+     *  Member Types
+     *  ------------
+     *  - value_type:      T;
+     *  - size_type:       std::size_t;
+     *  - difference_type: std::ptrdiff_t;
+     *  - pointer:         value_type *;
+     *  - const_pointer:   value_type const *;
+     *  - reference:       value_type &;
+     *  - const_reference: value_type const &;
+     *
+     *  Member Functions
+     *  ----------------
+     *  producer side:
+     *  - push/push_back:       inserts an element at the end if room is
+     *                          available; returns whether insertion happened
+     *  - emplace/emplace_back: constructs an element in-place at the end if
+     *                          room is available; returns whether insertion
+     *                          happened
+     *
+     *  consumer side:
+     *  - pop/pop_front: moves the first element into the provided reference
+     *                   if such an element exists; returns whether removal
+     *                   happened
+     *
+     *  either side:
+     *  - empty:    checks whether the buffer appears empty
+     *  - size:     returns the apparent number of buffered elements; the
+     *              value is a snapshot that may be stale by the time it is
+     *              read, but it is always conservative for the calling side
+     *              (a producer never observes more room than there is, a
+     *              consumer never observes more elements than there are)
+     *  - max_size: returns the maximum possible number of elements; this is
+     *              equal to N by definition.
+     *  - capacity: returns the number of elements that can be held in
+     *              currently allocated storage; this is equal to N by
+     *              definition.
+     */
+    template <typename T, std::size_t N>
+    class atomic_ringbuffer
+    {
+        static_assert (N > 0, "empty atomic_ringbuffer is not allowed");
+
+        /*
+         * one extra slot distinguishes the full buffer from the empty buffer
+         * without sharing a count between the two threads.
+         */
+        static constexpr std::size_t slots = N + 1;
+
+        using backing_type = std::array <memblock <T>, slots>;
+
+        static constexpr std::size_t cacheline_size = 64;
+
+        backing_type _buffer;
+
+        /* written by the consumer, read by the producer */
+        alignas (cacheline_size) std::atomic <std::size_t> _read;
+
+        /* written by the producer, read by the consumer */
+        alignas (cacheline_size) std::atomic <std::size_t> _write;
+
+        static std::size_t advance (std::size_t index) noexcept
+        {
+            return index + 1 == slots ? 0 : index + 1;
+        }
+
+        T * address_of (std::size_t index) noexcept
+        {
+            return reinterpret_cast <T *> (&this->_buffer [index]);
+        }
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer         = value_type *;
+        using const_pointer   = value_type const *;
+        using reference       = value_type &;
+        using const_reference = value_type const &;
+
+        atomic_ringbuffer (void) noexcept
+            : _buffer {}
+            , _read   {0}
+            , _write  {0}
+        {}
+
+        /*
+         * copies and moves are deleted; handing the buffer itself between
+         * threads mid-stream cannot be made atomic.
+         */
+        atomic_ringbuffer (atomic_ringbuffer const &) = delete;
+        atomic_ringbuffer & operator= (atomic_ringbuffer const &) = delete;
+
+        ~atomic_ringbuffer (void)
+            noexcept (std::is_nothrow_destructible <value_type>::value)
+        {
+            auto read = this->_read.load (std::memory_order_relaxed);
+            auto const write = this->_write.load (std::memory_order_relaxed);
+
+            while (read != write) {
+                this->address_of (read)->~value_type ();
+                read = advance (read);
+            }
+        }
+
+        /* checks whether the buffer appears empty */
+        bool empty (void) const noexcept
+        {
+            return this->_read.load (std::memory_order_acquire) ==
+                   this->_write.load (std::memory_order_acquire);
+        }
+
+        /* returns the apparent number of elements stored in the buffer */
+        size_type size (void) const noexcept
+        {
+            auto const read = this->_read.load (std::memory_order_acquire);
+            auto const write = this->_write.load (std::memory_order_acquire);
+
+            return write >= read ? write - read : slots - (read - write);
+        }
+
+        /* returns the maximum possible number of elements */
+        constexpr size_type max_size (void) const noexcept
+        {
+            return N;
+        }
+
+        /*
+         * returns the number of elements that can be held in the current
+         * storage
+         */
+        constexpr size_type capacity (void) const noexcept
+        {
+            return N;
+        }
+
+        /*
+         * Adds an object to the buffer if room is available; returns whether
+         * the object was added. May be called only from the producer thread.
+         */
+        bool push (value_type const & v)
+        {
+            auto const write = this->_write.load (std::memory_order_relaxed);
+            auto const next = advance (write);
+
+            if (next == this->_read.load (std::memory_order_acquire)) {
+                return false;
+            }
+
+            new (this->address_of (write)) value_type {v};
+            this->_write.store (next, std::memory_order_release);
+            return true;
+        }
+
+        /*
+         * Adds an object to the buffer if room is available; returns whether
+         * the object was added. May be called only from the producer thread.
+         */
+        bool push (value_type && v)
+        {
+            auto const write = this->_write.load (std::memory_order_relaxed);
+            auto const next = advance (write);
+
+            if (next == this->_read.load (std::memory_order_acquire)) {
+                return false;
+            }
+
+            new (this->address_of (write)) value_type {std::move (v)};
+            this->_write.store (next, std::memory_order_release);
+            return true;
+        }
+
+        bool push_back (value_type const & v)
+        {
+            return this->push (v);
+        }
+
+        bool push_back (value_type && v)
+        {
+            return this->push (std::move (v));
+        }
+
+        /*
+         * Adds an object to the buffer if room is available using in-place
+         * construction; returns whether the object was added. May be called
+         * only from the producer thread.
+         */
+        template <typename ... Args>
+        bool emplace (Args && ... args)
+        {
+            auto const write = this->_write.load (std::memory_order_relaxed);
+            auto const next = advance (write);
+
+            if (next == this->_read.load (std::memory_order_acquire)) {
+                return false;
+            }
+
+            new (this->address_of (write)) value_type {
+                std::forward <Args> (args)...
+            };
+            this->_write.store (next, std::memory_order_release);
+            return true;
+        }
+
+        template <typename ... Args>
+        bool emplace_back (Args && ... args)
+        {
+            return this->emplace (std::forward <Args> (args)...);
+        }
+
+        /*
+         * Moves the first element of the buffer into v if such an element
+         * exists; returns whether an element was removed. May be called only
+         * from the consumer thread.
+         */
+        bool pop (value_type & v)
+            noexcept (
+                std::is_nothrow_move_assignable <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            auto const read = this->_read.load (std::memory_order_relaxed);
+
+            if (read == this->_write.load (std::memory_order_acquire)) {
+                return false;
+            }
+
+            auto const addr = this->address_of (read);
+            v = std::move (*addr);
+            addr->~value_type ();
+            this->_read.store (advance (read), std::memory_order_release);
+            return true;
+        }
+
+        bool pop_front (value_type & v)
+            noexcept (noexcept (
+                std::declval <atomic_ringbuffer &> ().pop (v)
+            ))
+        {
+            return this->pop (v);
+        }
+    };
+}   // namespace dsa
+
+#endif // ifndef DSA_ATOMIC_RINGBUFFER_HPP
@@ -0,0 +1,396 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (mpmc_ringbuffer.hpp) is part of the dsa project.
+//
+// mpmc_ringbuffer; a fixed-size, lock-free multi-producer/multi-consumer
+// circular buffer for C++11 and later.
+//
+// The per-slot sequence number technique used here is due to Dmitry Vyukov;
+// a description can be found at:
+//
+//      http://www.1024cores.net/home/lock-free-algorithms/queues/
+//      bounded-mpmc-queue
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/atomic_ringbuffer.git
+// license:
+//
+// Copyright (c) 2016 DaltonWoodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_MPMC_RINGBUFFER_HPP
+#define DSA_MPMC_RINGBUFFER_HPP
+
+#include <array>        // std::array
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::ptrdiff_t, std::size_t
+#include <new>          // placement new
+#include <type_traits>  // std::is_nothrow_destructible,
+                        // std::is_nothrow_move_assignable
+#include <utility>      // std::forward, std::move
+
+
+namespace dsa
+{
+    /*
+     *  Description
+     *  -----------
+     *
+     *  dsa::mpmc_ringbuffer <> is a fixed-size circular buffer safe for
+     *  concurrent use by any number of producer threads and any number of
+     *  consumer threads, with no locks on either side.
+     *
+     *  Each slot carries its own atomic sequence number describing which
+     *  cycle of the buffer it belongs to. A producer claims a slot with a
+     *  single compare-and-swap on the enqueue position and publishes the
+     *  constructed element by bumping the slot's sequence number with a
+     *  release store; a consumer likewise claims a slot with a single
+     *  compare-and-swap on the dequeue position and releases it for the
+     *  next cycle once the element has been moved out. Producers therefore
+     *  never contend with consumers on shared state, only with each other
+     *  on the enqueue position (and symmetrically for consumers), which is
+     *  the property that makes this structure suitable as a queue backend
+     *  under heavy fan-out.
+     *
+     *  As with dsa::atomic_ringbuffer, operations do not throw on
+     *  exhaustion and there is no overwrite policy: push/emplace return
+     *  false when the buffer is full, and pop returns false when it is
+     *  empty, leaving progress decisions (retry, drop, back off, spill to
+     *  an unbounded structure) to the caller.
+     *
+     *  Template Parameters
+     *  -------------------
+     *  - T: the object type to be buffered. This type does *not* have to be
+     *  default constructable.
+     *
+     *  - N: the maximum number of elements for the buffer to hold; the
+     *  number N must be a nonzero power of two, so that positions can be
+     *  reduced to slot indices by masking rather than division.
+     *
+     *  Member Types
+     *  ------------
+     *  - value_type:      T;
+     *  - size_type:       std::size_t;
+     *  - difference_type: std::ptrdiff_t;
+     *  - pointer:         value_type *;
+     *  - const_pointer:   value_type const *;
+     *  - reference:       value_type &;
+     *  - const_reference: value_type const &;
+     *
+     *  Member Functions
+     *  ----------------
+     *  - push/push_back:       inserts an element at the end if room is
+     *                          available; returns whether insertion happened
+     *  - emplace/emplace_back: constructs an element in-place at the end if
+     *                          room is available; returns whether insertion
+     *                          happened
+     *  - pop/pop_front: moves the first element into the provided reference
+     *                   if such an element exists; returns whether removal
+     *                   happened
+     *
+     *  - empty:    checks whether the buffer appears empty
+     *  - size:     returns the apparent number of buffered elements; the
+     *              value is a snapshot that may be stale by the time it is
+     *              read
+     *  - max_size: returns the maximum possible number of elements; this is
+     *              equal to N by definition.
+     *  - capacity: returns the number of elements that can be held in
+     *              currently allocated storage; this is equal to N by
+     *              definition.
+     */
+    template <typename T, std::size_t N>
+    class mpmc_ringbuffer
+    {
+        static_assert (N > 0, "empty mpmc_ringbuffer is not allowed");
+        static_assert (
+            (N & (N - 1)) == 0,
+            "mpmc_ringbuffer capacity must be a power of two"
+        );
+
+        static constexpr std::size_t mask = N - 1;
+
+        static constexpr std::size_t cacheline_size = 64;
+
+        /*
+         * each slot pairs raw storage with the sequence number of the buffer
+         * cycle it currently belongs to; the sequence number alone decides
+         * whether the slot is ready for the next producer or the next
+         * consumer, so claiming threads never inspect each other's positions.
+         *
+         * the aligned raw storage is declared inline rather than through the
+         * usual anonymous-namespace memblock helper so that this header can
+         * be included alongside the other ringbuffer headers (and from
+         * task.hpp) without linkage clashes.
+         */
+        struct slot
+        {
+            std::atomic <std::size_t> sequence;
+            alignas (alignof (T)) unsigned char storage [sizeof (T)];
+        };
+
+        std::array <slot, N> _buffer;
+
+        /* written by producers only */
+        alignas (cacheline_size) std::atomic <std::size_t> _enqueue;
+
+        /* written by consumers only */
+        alignas (cacheline_size) std::atomic <std::size_t> _dequeue;
+
+        T * address_of (std::size_t index) noexcept
+        {
+            return reinterpret_cast <T *> (this->_buffer [index].storage);
+        }
+
+        /*
+         * claims the slot for the position held in the enqueue index,
+         * advancing the index past it; returns nullptr if the buffer is
+         * full.
+         */
+        slot * claim_enqueue_slot (std::size_t & pos) noexcept
+        {
+            pos = this->_enqueue.load (std::memory_order_relaxed);
+
+            while (true) {
+                auto const s = &this->_buffer [pos & mask];
+                auto const seq = s->sequence.load (std::memory_order_acquire);
+                auto const dif = static_cast <std::ptrdiff_t> (seq) -
+                                 static_cast <std::ptrdiff_t> (pos);
+
+                if (dif == 0) {
+                    if (this->_enqueue.compare_exchange_weak (
+                            pos, pos + 1, std::memory_order_relaxed
+                        ))
+                    {
+                        return s;
+                    }
+                } else if (dif < 0) {
+                    /* the slot still holds an element from the last cycle */
+                    return nullptr;
+                } else {
+                    pos = this->_enqueue.load (std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /*
+         * claims the slot for the position held in the dequeue index,
+         * advancing the index past it; returns nullptr if the buffer is
+         * empty.
+         */
+        slot * claim_dequeue_slot (std::size_t & pos) noexcept
+        {
+            pos = this->_dequeue.load (std::memory_order_relaxed);
+
+            while (true) {
+                auto const s = &this->_buffer [pos & mask];
+                auto const seq = s->sequence.load (std::memory_order_acquire);
+                auto const dif = static_cast <std::ptrdiff_t> (seq) -
+                                 static_cast <std::ptrdiff_t> (pos + 1);
+
+                if (dif == 0) {
+                    if (this->_dequeue.compare_exchange_weak (
+                            pos, pos + 1, std::memory_order_relaxed
+                        ))
+                    {
+                        return s;
+                    }
+                } else if (dif < 0) {
+                    /* no producer has published an element here yet */
+                    return nullptr;
+                } else {
+                    pos = this->_dequeue.load (std::memory_order_relaxed);
+                }
+            }
+        }
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer         = value_type *;
+        using const_pointer   = value_type const *;
+        using reference       = value_type &;
+        using const_reference = value_type const &;
+
+        mpmc_ringbuffer (void) noexcept
+            : _buffer  {}
+            , _enqueue {0}
+            , _dequeue {0}
+        {
+            for (std::size_t i = 0; i < N; ++i) {
+                this->_buffer [i].sequence.store (
+                    i, std::memory_order_relaxed
+                );
+            }
+        }
+
+        /*
+         * copies and moves are deleted; handing the buffer itself between
+         * threads mid-stream cannot be made atomic.
+         */
+        mpmc_ringbuffer (mpmc_ringbuffer const &) = delete;
+        mpmc_ringbuffer & operator= (mpmc_ringbuffer const &) = delete;
+
+        ~mpmc_ringbuffer (void)
+            noexcept (std::is_nothrow_destructible <value_type>::value)
+        {
+            auto read = this->_dequeue.load (std::memory_order_relaxed);
+            auto const write = this->_enqueue.load (std::memory_order_relaxed);
+
+            while (read != write) {
+                this->address_of (read & mask)->~value_type ();
+                read += 1;
+            }
+        }
+
+        /* checks whether the buffer appears empty */
+        bool empty (void) const noexcept
+        {
+            return this->size () == 0;
+        }
+
+        /* returns the apparent number of elements stored in the buffer */
+        size_type size (void) const noexcept
+        {
+            auto const read = this->_dequeue.load (std::memory_order_acquire);
+            auto const write = this->_enqueue.load (std::memory_order_acquire);
+
+            return write >= read ? write - read : 0;
+        }
+
+        /* returns the maximum possible number of elements */
+        constexpr size_type max_size (void) const noexcept
+        {
+            return N;
+        }
+
+        /*
+         * returns the number of elements that can be held in the current
+         * storage
+         */
+        constexpr size_type capacity (void) const noexcept
+        {
+            return N;
+        }
+
+        /*
+         * Adds an object to the buffer if room is available; returns whether
+         * the object was added. May be called from any thread.
+         */
+        bool push (value_type const & v)
+        {
+            std::size_t pos;
+            auto const s = this->claim_enqueue_slot (pos);
+
+            if (!s) {
+                return false;
+            }
+
+            new (this->address_of (pos & mask)) value_type {v};
+            s->sequence.store (pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /*
+         * Adds an object to the buffer if room is available; returns whether
+         * the object was added. May be called from any thread.
+         */
+        bool push (value_type && v)
+        {
+            std::size_t pos;
+            auto const s = this->claim_enqueue_slot (pos);
+
+            if (!s) {
+                return false;
+            }
+
+            new (this->address_of (pos & mask)) value_type {std::move (v)};
+            s->sequence.store (pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool push_back (value_type const & v)
+        {
+            return this->push (v);
+        }
+
+        bool push_back (value_type && v)
+        {
+            return this->push (std::move (v));
+        }
+
+        /*
+         * Adds an object to the buffer if room is available using in-place
+         * construction; returns whether the object was added. May be called
+         * from any thread.
+         */
+        template <typename ... Args>
+        bool emplace (Args && ... args)
+        {
+            std::size_t pos;
+            auto const s = this->claim_enqueue_slot (pos);
+
+            if (!s) {
+                return false;
+            }
+
+            new (this->address_of (pos & mask)) value_type {
+                std::forward <Args> (args)...
+            };
+            s->sequence.store (pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename ... Args>
+        bool emplace_back (Args && ... args)
+        {
+            return this->emplace (std::forward <Args> (args)...);
+        }
+
+        /*
+         * Moves the first element of the buffer into v if such an element
+         * exists; returns whether an element was removed. May be called from
+         * any thread.
+         */
+        bool pop (value_type & v)
+            noexcept (
+                std::is_nothrow_move_assignable <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            std::size_t pos;
+            auto const s = this->claim_dequeue_slot (pos);
+
+            if (!s) {
+                return false;
+            }
+
+            auto const addr = this->address_of (pos & mask);
+            v = std::move (*addr);
+            addr->~value_type ();
+
+            /* release the slot for the next cycle of the buffer */
+            s->sequence.store (pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop_front (value_type & v)
+            noexcept (noexcept (
+                std::declval <mpmc_ringbuffer &> ().pop (v)
+            ))
+        {
+            return this->pop (v);
+        }
+    };
+}   // namespace dsa
+
+#endif // ifndef DSA_MPMC_RINGBUFFER_HPP
@@ -29,13 +29,36 @@
 #define DSA_RINGBUFFER_HPP
 
 #include <array>        // std::array
-#include <exception>    // std::runtime_error
+#include <cstring>      // std::memcpy
+#include <stdexcept>    // std::runtime_error
 #include <type_traits>  // std::remove_cv, std::is_nothrow_move_assignable,
                         // std::is_nothrow_copy_assignable,
-                        // std::is_nothrow_destructible
+                        // std::is_nothrow_destructible,
+                        // std::is_trivially_copyable
 #include <utility>      // std::forward, std::move, std::swap
 
 
+#ifndef DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+#define DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+namespace dsa
+{
+    /*
+     * is_trivially_relocatable <T> is true when move constructing a T and
+     * destroying the source is equivalent to copying the object
+     * representation and abandoning the source without running its
+     * destructor. Every trivially copyable type qualifies, which is the
+     * default; user defined types whose moves only shuffle bytes may opt
+     * in by specializing this trait before instantiating the containers.
+     *
+     * the definition is repeated, behind this guard, in each header that
+     * relies on it so that the headers remain freestanding; all copies
+     * must stay identical.
+     */
+    template <class T>
+    struct is_trivially_relocatable : std::is_trivially_copyable <T> {};
+}   // namespace dsa
+#endif  // DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+
 namespace dsa
 {
 namespace
@@ -117,8 +140,12 @@ namespace
      *      - nothrow if T is nothrow copy constructible
      *
      *  ringbuffer (ringbuffer &&)
-     *      - move constructs buffer; copies overwrite policy
-     *      - nothrow if T is nothrow move constructible
+     *      - move constructs buffer; copies overwrite policy; the
+     *        moved-from buffer is left empty
+     *      - nothrow if T is nothrow move constructible and nothrow
+     *        destructible
+     *      - degrades to bulk copies of the object representation when
+     *        dsa::is_trivially_relocatable <T> holds
      *
      *  Assignment Operators
      *  --------------------
@@ -128,9 +155,12 @@ namespace
      *        constructible
      *
      *  operator= (ringbuffer &&)
-     *      - move assigns buffer; copies overwrite policy
+     *      - move assigns buffer; copies overwrite policy; the moved-from
+     *        buffer is left empty
      *      - nothrow if T is nothrow destructible and T is nothrow move
      *        constructible
+     *      - degrades to bulk copies of the object representation when
+     *        dsa::is_trivially_relocatable <T> holds
      *
      *  Member Functions
      *  ----------------
@@ -152,6 +182,19 @@ namespace
      *  - emplace/emplace_back: constructs an element in-place at the end
      *  - pop/pop_front:        removes the first element
      *
+     *  - push_n: inserts a contiguous run of elements at the end
+     *  - pop_n:  removes up to a given number of elements from the front,
+     *            moving them into a contiguous output range
+     *
+     *  - read_regions:  exposes the occupied storage as at most two
+     *                   contiguous (pointer, length) segments
+     *  - write_regions: exposes the free storage as at most two contiguous
+     *                   (pointer, length) segments
+     *  - commit:  publishes elements placed into the free segments by
+     *             external writes
+     *  - consume: retires elements drained from the occupied segments by
+     *             external reads
+     *
      *  - swap: swaps the contents. Template typename T must be Swappable.
      */
     template <typename T, std::size_t N>
@@ -263,8 +306,10 @@ namespace
             void swap (iterator_impl & other) noexcept
             {
                 std::swap (this->_iter, other._iter);
-                std::swap (this->_first, other._first);
-                std::swap (this->_last, other._last);
+                std::swap (this->_lfirst, other._lfirst);
+                std::swap (this->_llast, other._llast);
+                std::swap (this->_rfirst, other._rfirst);
+                std::swap (this->_rlast, other._rlast);
             }
 
             iterator_impl & operator++ (void)
@@ -330,9 +375,31 @@ namespace
                  *      b. this is below _llast
                  */
 
-                /* case i. */
+                /*
+                 * case i. -- note that the privileged iterators of the
+                 * container have a logical region spanning the whole of the
+                 * backing buffer, and so even in the contiguous case we must
+                 * wrap around the real region boundaries.
+                 */
                 if (this->logical_region_is_contiguous ()) {
-                    _iter += n;
+                    if (n >= 0) {
+                        /* stays in-bounds */
+                        if (_iter + n <= _rlast) {
+                            _iter += n;
+                        /* overflow past-the-end */
+                        } else {
+                            _iter = _rfirst + (n - 1 - (_rlast - _iter));
+                        }
+                    } else {
+                        /* stays in-bounds */
+                        if (_iter + n >= _rfirst) {
+                            _iter += n;
+                        /* underflows before-the-beginning */
+                        } else {
+                            auto const m {-n};
+                            _iter = _rlast - (m - 1 - (_iter - _rfirst));
+                        }
+                    }
                 /* cast ii.a. */
                 } else if (_lfirst <= _iter) {
                     /* stays in-bounds */
@@ -506,24 +573,17 @@ namespace
         }
 
         ringbuffer (ringbuffer && other)
-            noexcept (std::is_nothrow_move_constructible <value_type>::value)
+            noexcept (
+                std::is_nothrow_move_constructible <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
             : _buffer   {}
-            , _buffered {other._buffered}
+            , _buffered {0}
             , _owpolicy {other._owpolicy}
         {
-            auto ti {this->_tail};
-            auto oi {other.cbegin ()};
-            auto ob {other._buffered};
-
-            while (ob) {
-                auto const addr {ti.addressof ()};
-                new (addr) value_type {std::move (*oi)};
-                ti += 1;
-                oi += 1;
-                ob -= 1;
-            }
-
-            this->_tail += this->_buffered;
+            this->adopt_contents_ (
+                other, is_trivially_relocatable <value_type> {}
+            );
         }
 
         ringbuffer & operator= (ringbuffer const & other)
@@ -564,15 +624,66 @@ namespace
         {
             this->clear ();
             this->_owpolicy = other._owpolicy;
+            this->adopt_contents_ (
+                other, is_trivially_relocatable <value_type> {}
+            );
+            return *this;
+        }
 
-            auto oi {other.cbegin ()};
-            auto ob {other._buffered};
+    private:
+        static void destruct (pointer p)
+            noexcept (std::is_nothrow_destructible <value_type>::value)
+        {
+            p->~value_type ();
+        }
 
-            while (ob) {
+        /*
+         * adopts the contents of other by relocation, leaving other empty.
+         * when value_type is trivially relocatable the (at most two)
+         * occupied segments of the source are forwarded to the bulk write
+         * path, which copies the object representations with std::memcpy
+         * and abandons the source elements without running destructors;
+         * otherwise each element is move constructed here and destroyed in
+         * the source.
+         */
+        void adopt_contents_ (ringbuffer & other, std::true_type) noexcept
+        {
+            auto const src {other._head.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (other._last) - src
+            ) + 1};
+            auto const count {other._buffered};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            if (first_segment) {
+                this->push_n_impl (src, first_segment, std::true_type {});
+            }
+            if (count > first_segment) {
+                this->push_n_impl (
+                    reinterpret_cast <pointer> (other._first),
+                    count - first_segment,
+                    std::true_type {}
+                );
+            }
+
+            other._head += static_cast <difference_type> (count);
+            other._buffered = 0;
+        }
+
+        void adopt_contents_ (ringbuffer & other, std::false_type)
+            noexcept (
+                std::is_nothrow_move_constructible <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            while (other._buffered) {
                 auto const addr {this->_tail.addressof ()};
-                new (addr) value_type {std::move (*oi)};
-                oi += 1;
-                ob -= 1;
+                new (addr) value_type {std::move (*other._head)};
+                destruct (other._head.addressof ());
+                other._head += 1;
+                other._buffered -= 1;
 
                 /*
                  * we leave this here in the case that T is not nothrow move
@@ -582,15 +693,6 @@ namespace
                 this->_buffered += 1;
                 this->_tail += 1;
             }
-
-            return *this;
-        }
-
-    private:
-        static void destruct (pointer p)
-            noexcept (std::is_nothrow_destructible <value_type>::value)
-        {
-            p->~value_type ();
         }
 
     public:
@@ -689,7 +791,7 @@ namespace
         /* checks whether the buffer is empty */
         bool empty (void) const noexcept
         {
-            return _buffered != 0;
+            return _buffered == 0;
         }
 
         /* returns the number of elements stored in the buffer */
@@ -806,13 +908,21 @@ namespace
         /* returns a reference to the last element in the buffer */
         reference back (void) noexcept
         {
-            return _tail == _head ? _tail [0] : _tail [-1];
+            /*
+             * _tail == _head cannot distinguish a full buffer from an
+             * empty one, so the occupancy count decides the case.
+             */
+            return _buffered == 0 ? _tail [0] : _tail [-1];
         }
 
         /* returns a reference to the last element in the buffer */
         const_reference back (void) const noexcept
         {
-            return _tail == _head ? _tail [0] : _tail [-1];
+            /*
+             * _tail == _head cannot distinguish a full buffer from an
+             * empty one, so the occupancy count decides the case.
+             */
+            return _buffered == 0 ? _tail [0] : _tail [-1];
         }
 
         /*
@@ -948,6 +1058,299 @@ namespace
                 _buffered -= 1;
             }
         }
+
+    private:
+        /*
+         * bulk writes and reads decompose the logical region into its at most
+         * two contiguous segments up front, so that trivially copyable types
+         * degrade to at most two calls to std::memcpy over the backing buffer
+         * rather than per-element construction.
+         */
+        void push_n_impl (const_pointer src,
+                          std::size_t count,
+                          std::true_type) noexcept
+        {
+            auto const dst {_tail.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (_last) - dst
+            ) + 1};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            std::memcpy (
+                static_cast <void *> (dst),
+                src,
+                first_segment * sizeof (value_type)
+            );
+
+            if (count > first_segment) {
+                std::memcpy (
+                    static_cast <void *> (reinterpret_cast <pointer> (_first)),
+                    src + first_segment,
+                    (count - first_segment) * sizeof (value_type)
+                );
+            }
+
+            _tail += static_cast <difference_type> (count);
+            _buffered += count;
+        }
+
+        void push_n_impl (const_pointer src,
+                          std::size_t count,
+                          std::false_type)
+        {
+            while (count) {
+                auto const addr {_tail.addressof ()};
+                new (addr) value_type {*src};
+                src += 1;
+                count -= 1;
+
+                /*
+                 * we leave this here in the case that T is not nothrow copy
+                 * constructible, so that in the case of an exception being
+                 * thrown the container remains in a consistent state.
+                 */
+                _buffered += 1;
+                _tail += 1;
+            }
+        }
+
+        void pop_n_impl (pointer out,
+                         std::size_t count,
+                         std::true_type) noexcept
+        {
+            auto const src {_head.addressof ()};
+            auto const contiguous {static_cast <std::size_t> (
+                reinterpret_cast <pointer> (_last) - src
+            ) + 1};
+            auto const first_segment {
+                count < contiguous ? count : contiguous
+            };
+
+            std::memcpy (
+                static_cast <void *> (out),
+                src,
+                first_segment * sizeof (value_type)
+            );
+
+            if (count > first_segment) {
+                std::memcpy (
+                    static_cast <void *> (out + first_segment),
+                    reinterpret_cast <pointer> (_first),
+                    (count - first_segment) * sizeof (value_type)
+                );
+            }
+
+            _head += static_cast <difference_type> (count);
+            _buffered -= count;
+        }
+
+        void pop_n_impl (pointer out,
+                         std::size_t count,
+                         std::false_type)
+            noexcept (
+                std::is_nothrow_move_assignable <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            while (count) {
+                auto const addr {_head.addressof ()};
+                *out = std::move (*addr);
+                destruct (addr);
+                out += 1;
+                count -= 1;
+                _head += 1;
+                _buffered -= 1;
+            }
+        }
+
+    public:
+        /*
+         * Adds a contiguous run of count objects to the buffer.
+         *
+         * If fewer than count spaces are available, then:
+         *      If the overwrite policy is set to no_overwrite this method
+         *      throws an exception of type std::runtime_error and the buffer
+         *      is left unmodified.
+         *
+         *      If the overwrite policy is set to overwrite, this method
+         *      overwrites as many elements at the front of the buffer as are
+         *      required to make room; if count exceeds the capacity of the
+         *      buffer then only the last N objects of the run are buffered.
+         */
+        void push_n (const_pointer src, std::size_t count)
+        {
+            if (count > N - _buffered) {
+                if (_owpolicy == overwrite_policy::no_overwrite) {
+                    throw std::runtime_error {"push_n on full buffer"};
+                }
+
+                if (count > N) {
+                    src += count - N;
+                    count = N;
+                }
+
+                auto drop {count - (N - _buffered)};
+
+                while (drop) {
+                    destruct (_head.addressof ());
+                    _head += 1;
+                    _buffered -= 1;
+                    drop -= 1;
+                }
+            }
+
+            if (count > 0) {
+                this->push_n_impl (
+                    src, count, std::is_trivially_copyable <value_type> {}
+                );
+            }
+        }
+
+        /*
+         * Moves up to count elements from the front of the buffer into the
+         * contiguous range beginning at out; returns the number of elements
+         * removed, which is the smaller of count and size ().
+         */
+        std::size_t pop_n (pointer out, std::size_t count)
+            noexcept (
+                std::is_nothrow_move_assignable <value_type>::value &&
+                std::is_nothrow_destructible <value_type>::value
+            )
+        {
+            if (count > _buffered) {
+                count = _buffered;
+            }
+
+            if (count > 0) {
+                this->pop_n_impl (
+                    out, count, std::is_trivially_copyable <value_type> {}
+                );
+            }
+
+            return count;
+        }
+
+        /*
+         * contiguous views of buffer storage for scatter-gather I/O; see
+         * read_regions and write_regions below.
+         */
+        struct segment
+        {
+            pointer data;
+            size_type length;
+        };
+
+        struct const_segment
+        {
+            const_pointer data;
+            size_type length;
+        };
+
+        /*
+         * Fills segs with the occupied storage as at most two contiguous
+         * segments in logical (oldest first) order and returns the number of
+         * nonempty segments. Together with consume, this permits gather I/O
+         * (e.g. writev) directly out of the buffer with no staging copy.
+         */
+        size_type read_regions (const_segment (& segs) [2]) const noexcept
+        {
+            auto const head {_head.addressof ()};
+            auto const contiguous {static_cast <size_type> (
+                reinterpret_cast <const_pointer> (_last) - head
+            ) + 1};
+            auto const first_segment {
+                _buffered < contiguous ? _buffered : contiguous
+            };
+
+            segs [0] = const_segment {head, first_segment};
+            segs [1] = const_segment {
+                reinterpret_cast <const_pointer> (_first),
+                _buffered - first_segment
+            };
+
+            return segs [1].length ? 2 : (segs [0].length ? 1 : 0);
+        }
+
+        /*
+         * Fills segs with the free storage as at most two contiguous
+         * segments in write order and returns the number of nonempty
+         * segments. Together with commit, this permits scatter I/O (e.g.
+         * readv) directly into the buffer with no staging copy; external
+         * writes can only produce trivially copyable objects.
+         */
+        size_type write_regions (segment (& segs) [2]) noexcept
+        {
+            static_assert (
+                std::is_trivially_copyable <value_type>::value,
+                "scatter I/O into the buffer requires a trivially copyable"
+                " value type"
+            );
+
+            auto const tail {_tail.addressof ()};
+            auto const avail {N - _buffered};
+            auto const contiguous {static_cast <size_type> (
+                reinterpret_cast <pointer> (_last) - tail
+            ) + 1};
+            auto const first_segment {
+                avail < contiguous ? avail : contiguous
+            };
+
+            segs [0] = segment {tail, first_segment};
+            segs [1] = segment {
+                reinterpret_cast <pointer> (_first),
+                avail - first_segment
+            };
+
+            return segs [1].length ? 2 : (segs [0].length ? 1 : 0);
+        }
+
+        /*
+         * Publishes n elements that external writes have placed into the
+         * storage returned by write_regions, advancing the write position.
+         * Throws an exception of type std::runtime_error if n exceeds the
+         * free capacity.
+         */
+        void commit (size_type n)
+        {
+            static_assert (
+                std::is_trivially_copyable <value_type>::value,
+                "scatter I/O into the buffer requires a trivially copyable"
+                " value type"
+            );
+
+            if (n > N - _buffered) {
+                throw std::runtime_error {"commit beyond free capacity"};
+            }
+
+            _tail += static_cast <difference_type> (n);
+            _buffered += n;
+        }
+
+        /*
+         * Retires up to n elements that external reads have drained from the
+         * storage returned by read_regions, advancing the read position;
+         * returns the number of elements retired.
+         */
+        size_type consume (size_type n)
+            noexcept (std::is_nothrow_destructible <value_type>::value)
+        {
+            if (n > _buffered) {
+                n = _buffered;
+            }
+
+            auto m {n};
+
+            while (m) {
+                destruct (_head.addressof ());
+                _head += 1;
+                _buffered -= 1;
+                m -= 1;
+            }
+
+            return n;
+        }
     };
 }   // namespace dsa
 
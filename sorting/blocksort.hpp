@@ -25,11 +25,17 @@
 #ifndef DSA_SORTING_BLOCKSORT_HPP
 #define DSA_SORTING_BLOCKSORT_HPP
 
-#include <algorithm>    // std::rotate, std::inplace_merge
+#include <algorithm>    // std::rotate, std::lower_bound, std::upper_bound
 #include <array>        // std::array
 #include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
 #include <functional>   // std::less
+#include <future>       // std::future
 #include <iterator>     // std::iterator_traits
+#include <thread>       // std::thread::hardware_concurrency
+#include <vector>       // std::vector
+#include "execution.hpp"
+#include "sorting_network.hpp"
 
 
 namespace dsa
@@ -59,6 +65,190 @@ namespace
             }
         }
     }
+
+    /*
+     * base case sort for blocks of length 16-31: the leading elements are
+     * sorted branchlessly by the largest applicable sorting network and the
+     * remainder folded in by insertion, so on arithmetic types with the
+     * default comparison the leaf level runs on (vectorizable) min/max
+     * operations rather than the gapped insertion loop.
+     */
+    template <typename RandomIt, typename Compare>
+    static void small_sort_impl (
+        RandomIt first, RandomIt last, Compare comp, std::true_type
+    )
+    {
+        auto const length {static_cast <std::size_t> (last - first)};
+
+        std::size_t sorted;
+        if (length >= 16) {
+            detail::network_sort_16 (first);
+            sorted = 16;
+        } else if (length >= 8) {
+            detail::network_sort_8 (first);
+            sorted = 8;
+        } else if (length >= 4) {
+            detail::network_sort_4 (first);
+            sorted = 4;
+        } else {
+            sorted = length > 0;
+        }
+
+        for (std::size_t i = sorted; i < length; ++i) {
+            auto const tmp {first [i]};
+
+            std::size_t j;
+            for (j = i; j > 0 && comp (tmp, first [j - 1]); --j) {
+                first [j] = first [j - 1];
+            }
+
+            first [j] = tmp;
+        }
+    }
+
+    template <typename RandomIt, typename Compare>
+    static void small_sort_impl (
+        RandomIt first, RandomIt last, Compare comp, std::false_type
+    )
+    {
+        shellsort (first, last, comp);
+    }
+
+    template <typename RandomIt, typename Compare>
+    static void small_sort (RandomIt first, RandomIt last, Compare comp)
+    {
+        using value_type = typename std::iterator_traits <RandomIt>::value_type;
+
+        small_sort_impl (
+            first, last, comp,
+            typename detail::use_sorting_network <
+                value_type, Compare
+            >::type {}
+        );
+    }
+
+    /*
+     * stable merge of the consecutive sorted runs [first, mid) and
+     * [mid, last) by rotation: the larger run is bisected, the matching
+     * split point in the other run located by binary search, the middle
+     * sections rotated into order, and the two halves merged recursively.
+     * O(1) space and no allocations, at the cost of O(n·log n) element
+     * moves per merge.
+     */
+    template <typename RandomIt, typename Compare>
+    static void rotation_merge (
+        RandomIt first, RandomIt mid, RandomIt last, Compare comp
+    )
+    {
+        auto const len1 {static_cast <std::size_t> (mid - first)};
+        auto const len2 {static_cast <std::size_t> (last - mid)};
+
+        if (len1 == 0 || len2 == 0) {
+            return;
+        }
+
+        if (len1 + len2 == 2) {
+            if (comp (*mid, *first)) {
+                std::iter_swap (first, mid);
+            }
+            return;
+        }
+
+        RandomIt cut1, cut2;
+        if (len1 >= len2) {
+            cut1 = first + len1 / 2;
+            cut2 = std::lower_bound (mid, last, *cut1, comp);
+        } else {
+            cut2 = mid + len2 / 2;
+            cut1 = std::upper_bound (first, mid, *cut2, comp);
+        }
+
+        auto const new_mid {cut1 + (cut2 - mid)};
+        std::rotate (cut1, mid, cut2);
+
+        rotation_merge (first, cut1, new_mid, comp);
+        rotation_merge (new_mid, cut2, last, comp);
+    }
+
+    /*
+     * stable merge of [first, mid) and [mid, last) through the provided
+     * buffer, which must hold at least mid - first valid objects: the left
+     * run is moved out and merged back against the right run front to
+     * back. Left run elements win ties, preserving stability.
+     */
+    template <typename RandomIt, typename T, typename Compare>
+    static void buffered_merge_left (
+        RandomIt first, RandomIt mid, RandomIt last, T * buffer, Compare comp
+    )
+    {
+        auto const buffer_end {std::move (first, mid, buffer)};
+
+        auto l = buffer;
+        auto r = mid;
+        auto out = first;
+
+        while (l != buffer_end && r != last) {
+            if (comp (*r, *l)) {
+                *out++ = std::move (*r++);
+            } else {
+                *out++ = std::move (*l++);
+            }
+        }
+
+        /* any remaining right run elements are already in position */
+        std::move (l, buffer_end, out);
+    }
+
+    /*
+     * mirror image of buffered_merge_left for when the right run is the
+     * smaller: the right run is moved out and merged back to front, with
+     * right run elements losing ties.
+     */
+    template <typename RandomIt, typename T, typename Compare>
+    static void buffered_merge_right (
+        RandomIt first, RandomIt mid, RandomIt last, T * buffer, Compare comp
+    )
+    {
+        auto const buffer_end {std::move (mid, last, buffer)};
+
+        auto l = mid;
+        auto r = buffer_end;
+        auto out = last;
+
+        while (l != first && r != buffer) {
+            if (comp (*(r - 1), *(l - 1))) {
+                *--out = std::move (*--l);
+            } else {
+                *--out = std::move (*--r);
+            }
+        }
+
+        std::move (buffer, r, out - (r - buffer));
+    }
+
+    /*
+     * merges the consecutive sorted runs [first, mid) and [mid, last),
+     * using the scratch buffer when the smaller run fits into it and the
+     * allocation-free rotation merge otherwise; unlike std::inplace_merge
+     * this never allocates behind the caller's back.
+     */
+    template <typename RandomIt, typename T, typename Compare>
+    static void merge_runs (
+        RandomIt first, RandomIt mid, RandomIt last,
+        Compare comp, T * scratch, std::size_t scratch_length
+    )
+    {
+        auto const len1 {static_cast <std::size_t> (mid - first)};
+        auto const len2 {static_cast <std::size_t> (last - mid)};
+
+        if (len1 <= len2 && len1 <= scratch_length) {
+            buffered_merge_left (first, mid, last, scratch, comp);
+        } else if (len2 <= scratch_length) {
+            buffered_merge_right (first, mid, last, scratch, comp);
+        } else {
+            rotation_merge (first, mid, last, comp);
+        }
+    }
 }   // anonymous namespace
 
     /*
@@ -89,14 +279,32 @@ namespace
      *    where T1 and T2 are such that an object of type RandomIt can be
      *    dereferenced and then implicitly converted to both types.
      *
+     *  The merge passes never allocate: each merge runs through the caller
+     *  provided scratch buffer when the smaller of its two runs fits, and
+     *  through an O(1) space rotation-based merge otherwise. The overloads
+     *  without a scratch buffer therefore perform zero hidden allocations
+     *  (unlike std::inplace_merge, whose internal buffer acquisition is
+     *  outside the caller's control), and the overloads with one give a
+     *  memory footprint that is known up front; a scratch buffer of half
+     *  the range length makes every merge a buffered one.
+     *
      *  Parameters
      *  ----------
      *  - RandomIt first: an iterator to the first element in the range to sort
      *  - RandomIt last: an iterator to one past the end of the range to sort
      *  - Compare comp: the comparison function object to be used in sorting
+     *  - T * scratch: a buffer of scratch_length valid objects of the
+     *    iterator's value type (for instance the contents of a
+     *    std::vector), reused across all merge passes
+     *      [default: none]
+     *  - std::size_t scratch_length: the number of objects in scratch
+     *      [default: 0]
      */
-    template <typename RandomIt, typename Compare>
-    void blocksort (RandomIt first, RandomIt last, Compare comp)
+    template <typename RandomIt, typename Compare, typename T>
+    void blocksort (
+        RandomIt first, RandomIt last, Compare comp,
+        T * scratch, std::size_t scratch_length
+    )
     {
         auto const rangelen {static_cast <std::uint64_t> (last - first)};
 
@@ -130,7 +338,7 @@ namespace
                 first + static_cast <std::size_t> ((b + 16) * scale)
             };
 
-            shellsort (block_start, block_end, comp);
+            small_sort (block_start, block_end, comp);
         }
 
         /* rotate and merge increasingly long ranges to finish sort */
@@ -151,20 +359,247 @@ namespace
                 if (comp (*(range_end - 1), *range_start)) {
                     std::rotate (range_start, range_mid, range_end);
                 } else if (comp (*range_mid, *(range_mid - 1))) {
-                    std::inplace_merge (
-                        range_start, range_mid, range_end, comp
+                    merge_runs (
+                        range_start, range_mid, range_end, comp,
+                        scratch, scratch_length
                     );
                 }
             }
         }
     }
 
+    template <typename RandomIt, typename T>
+    void blocksort (
+        RandomIt first, RandomIt last, T * scratch,
+        std::size_t scratch_length
+    )
+    {
+        using value_type = typename std::iterator_traits <RandomIt>::value_type;
+        blocksort (
+            first, last, std::less <value_type> {}, scratch, scratch_length
+        );
+    }
+
+    template <typename RandomIt, typename Compare>
+    void blocksort (RandomIt first, RandomIt last, Compare comp)
+    {
+        using value_type = typename std::iterator_traits <RandomIt>::value_type;
+        blocksort (
+            first, last, comp, static_cast <value_type *> (nullptr), 0
+        );
+    }
+
     template <typename RandomIt>
     void blocksort (RandomIt first, RandomIt last)
     {
         using value_type = typename std::iterator_traits <RandomIt>::value_type;
         blocksort (first, last, std::less <value_type> {});
     }
+
+    template <typename RandomIt, typename Compare>
+    void blocksort (
+        execution::sequenced_policy, RandomIt first, RandomIt last,
+        Compare comp
+    )
+    {
+        blocksort (first, last, comp);
+    }
+
+    template <typename RandomIt>
+    void blocksort (execution::sequenced_policy, RandomIt first, RandomIt last)
+    {
+        blocksort (first, last);
+    }
+
+    /*
+     * parallel blocksort sorting algorithm
+     *
+     *  Description
+     *  -----------
+     *
+     *  Sorts the range exactly as the sequential blocksort overload does, but
+     *  distributes the work across the workers of the provided task system:
+     *  the initial blocks are shellsorted by independent tasks, and each
+     *  merge pass submits its (pairwise disjoint) merge operations as tasks,
+     *  joining between passes since each pass consumes the runs produced by
+     *  the one before it. The call returns only once the range is fully
+     *  sorted. Ranges too short to repay the scheduling overhead are handed
+     *  to the sequential overload.
+     *
+     *  The calling thread must not be one of the task system's own workers;
+     *  it blocks on the futures of each pass.
+     *
+     *  Template Parameters
+     *  -------------------
+     *  - TaskSystem: a tasking system with a member push accepting a nullary
+     *    callable and returning a std::future to its result, such as
+     *    dsa::task_system <>; the parameter is a template so that the
+     *    sorting component remains self-contained.
+     *  - RandomIt: an iterator type modeling RandomAccessIterator
+     *  - Compare: a function type with signature comparable to
+     *
+     *      bool cmp (T1 const &, T2 const &)
+     *
+     *    where T1 and T2 are such that an object of type RandomIt can be
+     *    dereferenced and then implicitly converted to both types.
+     *
+     *  Parameters
+     *  ----------
+     *  - execution::parallel_policy: tag selecting this overload
+     *  - TaskSystem & tasks: the task system on whose workers to execute
+     *  - RandomIt first: an iterator to the first element in the range to sort
+     *  - RandomIt last: an iterator to one past the end of the range to sort
+     *  - Compare comp: the comparison function object to be used in sorting
+     */
+    template <typename TaskSystem, typename RandomIt, typename Compare>
+    void blocksort (
+        execution::parallel_policy, TaskSystem & tasks,
+        RandomIt first, RandomIt last, Compare comp
+    )
+    {
+        auto const rangelen {static_cast <std::uint64_t> (last - first)};
+
+        /* short ranges do not repay the scheduling overhead */
+        if (rangelen < 4096) {
+            return blocksort (first, last, comp);
+        }
+
+        /* previous power of 2 below rangelen */
+        auto rl = rangelen;
+        std::size_t const rl_pow2 = (
+            rl |= rl >> 1,
+            rl |= rl >> 2,
+            rl |= rl >> 4,
+            rl |= rl >> 8,
+            rl |= rl >> 16,
+            rl |= rl >> 32,
+            rl - (rl >> 1)
+        );
+
+        /*
+         * scale is a multiplier between 1.0 and 2.0 determining the length of
+         * the blocks to be worked on in the first portion of the algorithm
+         */
+        auto const scale {
+            static_cast <double> (rangelen) /
+                static_cast <double> (rl_pow2)
+        };
+
+        auto const width {
+            static_cast <std::size_t> (
+                std::max (1u, std::thread::hardware_concurrency ())
+            )
+        };
+
+        /*
+         * elements covered per task: enough to amortize scheduling, few
+         * enough tasks to spread each pass across the workers. Rounded up
+         * to a multiple of 16 because blocks live on the global grid of
+         * 16; a chunk boundary inside a block would hand the same block
+         * to two concurrent tasks and misalign the runs the merge passes
+         * expect.
+         */
+        std::size_t const per_task = (std::max <std::size_t> (
+            4096, (rl_pow2 + 4 * width - 1) / (4 * width)
+        ) + 15) / 16 * 16;
+
+        std::vector <std::future <void>> pass;
+
+        /* sort blocks (of length 16-31, depending on scale) in parallel */
+        for (std::size_t b = 0; b < rl_pow2; b += per_task) {
+            auto const b_end {std::min (rl_pow2, b + per_task)};
+
+            pass.emplace_back (tasks.push (
+                [first, scale, comp, b, b_end] {
+                    for (std::size_t blk = b; blk < b_end; blk += 16) {
+                        auto const block_start {
+                            first + static_cast <std::size_t> (blk * scale)
+                        };
+                        auto const block_end {
+                            first + static_cast <std::size_t> (
+                                (blk + 16) * scale
+                            )
+                        };
+
+                        small_sort (block_start, block_end, comp);
+                    }
+                }
+            ));
+        }
+
+        for (auto & f : pass) { f.get (); }
+        pass.clear ();
+
+        /*
+         * rotate and merge increasingly long ranges to finish the sort; the
+         * merges within one pass touch pairwise disjoint ranges and so run
+         * as independent tasks, while passes are separated by a join since
+         * each consumes the runs produced by the pass before it.
+         */
+        for (std::size_t len = 16; len < rl_pow2; len *= 2) {
+            auto const merges_per_task {
+                std::max <std::size_t> (1, per_task / (len * 2))
+            };
+            auto const stride {merges_per_task * len * 2};
+
+            for (std::size_t chunk = 0; chunk < rl_pow2; chunk += stride) {
+                auto const chunk_end {std::min (rl_pow2, chunk + stride)};
+
+                pass.emplace_back (tasks.push (
+                    [first, scale, comp, len, chunk, chunk_end] {
+                        for (std::size_t merge = chunk; merge < chunk_end;
+                             merge += len * 2)
+                        {
+                            auto const range_start {
+                                first + static_cast <std::size_t> (
+                                    merge * scale
+                                )
+                            };
+                            auto const range_mid {
+                                first + static_cast <std::size_t> (
+                                    (merge + len) * scale
+                                )
+                            };
+                            auto const range_end {
+                                first + static_cast <std::size_t> (
+                                    (merge + (len * 2)) * scale
+                                )
+                            };
+
+                            if (comp (*(range_end - 1), *range_start)) {
+                                std::rotate (
+                                    range_start, range_mid, range_end
+                                );
+                            } else if (comp (*range_mid, *(range_mid - 1))) {
+                                /*
+                                 * merge tasks run concurrently and so
+                                 * cannot share a scratch buffer; the
+                                 * rotation path keeps them allocation
+                                 * free
+                                 */
+                                rotation_merge (
+                                    range_start, range_mid, range_end, comp
+                                );
+                            }
+                        }
+                    }
+                ));
+            }
+
+            for (auto & f : pass) { f.get (); }
+            pass.clear ();
+        }
+    }
+
+    template <typename TaskSystem, typename RandomIt>
+    void blocksort (
+        execution::parallel_policy policy, TaskSystem & tasks,
+        RandomIt first, RandomIt last
+    )
+    {
+        using value_type = typename std::iterator_traits <RandomIt>::value_type;
+        blocksort (policy, tasks, first, last, std::less <value_type> {});
+    }
 }   // namespace dsa
 
 #endif  // #ifndef DSA_SORTING_BLOCKSORT_HPP
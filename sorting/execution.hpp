@@ -0,0 +1,53 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (execution.hpp) is part of the dsa project.
+//
+// execution; execution policy tags for the parallel overloads of the sorting
+// algorithms, in the style of the C++17 Library Extensions for Parallelism:
+//
+//      http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2015/n4507.html
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/sorting.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_SORTING_EXECUTION_HPP
+#define DSA_SORTING_EXECUTION_HPP
+
+
+namespace dsa
+{
+namespace execution
+{
+    /*
+     * requires that the algorithm overload execute entirely on the calling
+     * thread; overloads taking this tag behave exactly as the corresponding
+     * untagged overloads.
+     */
+    struct sequenced_policy {};
+
+    /*
+     * permits the algorithm overload to distribute independent portions of
+     * its work across the workers of an accompanying task system; the call
+     * itself still returns only once the whole algorithm has completed.
+     */
+    struct parallel_policy {};
+
+    constexpr sequenced_policy seq {};
+    constexpr parallel_policy par {};
+}   // namespace execution
+}   // namespace dsa
+
+#endif  // #ifndef DSA_SORTING_EXECUTION_HPP
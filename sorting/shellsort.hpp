@@ -25,11 +25,16 @@
 #ifndef DSA_SORTING_SHELLSORT_HPP
 #define DSA_SORTING_SHELLSORT_HPP
 
+#include <algorithm>    // std::min
 #include <array>        // std::array
 #include <cstddef>      // std::size_t
 #include <functional>   // std::less
+#include <future>       // std::future
 #include <iterator>     // std::iterator_traits
+#include <thread>       // std::thread::hardware_concurrency
 #include <utility>      // std::swap
+#include <vector>       // std::vector
+#include "execution.hpp"
 
 
 namespace dsa
@@ -137,6 +142,161 @@ namespace
         using value_type = typename std::iterator_traits <RandomIt>::value_type;
         shellsort (first, last, std::less <value_type> {}, seq);
     }
+
+    template <typename RandomIt, typename Compare>
+    void shellsort (
+        execution::sequenced_policy, RandomIt first, RandomIt last,
+        Compare comp, enum shellseq seq = shellseq::curia01
+    )
+    {
+        shellsort (first, last, comp, seq);
+    }
+
+    template <typename RandomIt>
+    void shellsort (
+        execution::sequenced_policy, RandomIt first, RandomIt last,
+        enum shellseq seq = shellseq::curia01
+    )
+    {
+        shellsort (first, last, seq);
+    }
+
+    /*
+     * parallel shellsort sorting algorithm
+     *
+     *  Description
+     *  -----------
+     *
+     *  Sorts the range exactly as the sequential shellsort overload does,
+     *  but distributes the work of each gap pass across the workers of the
+     *  provided task system. For a gap g the range decomposes into g
+     *  interleaved chains, each an independent insertion sort, so the chains
+     *  are partitioned across tasks; passes are separated by a join since
+     *  each gap refines the ordering established by the one before it. Gaps
+     *  too small to split usefully (including the final gap of 1) run on the
+     *  calling thread, so parallelism helps most on the long early passes.
+     *  Ranges too short to repay the scheduling overhead are handed to the
+     *  sequential overload.
+     *
+     *  The calling thread must not be one of the task system's own workers;
+     *  it blocks on the futures of each pass.
+     *
+     *  Template Parameters
+     *  -------------------
+     *  - TaskSystem: a tasking system with a member push accepting a nullary
+     *    callable and returning a std::future to its result, such as
+     *    dsa::task_system <>; the parameter is a template so that the
+     *    sorting component remains self-contained.
+     *  - RandomIt: an iterator type modeling RandomAccessIterator
+     *  - Compare: a function type with signature comparable to
+     *
+     *      bool cmp (T1 const &, T2 const &)
+     *
+     *    where T1 and T2 are such that an object of type RandomIt can be
+     *    dereferenced and then implicitly converted to both types.
+     *
+     *  Parameters
+     *  ----------
+     *  - execution::parallel_policy: tag selecting this overload
+     *  - TaskSystem & tasks: the task system on whose workers to execute
+     *  - RandomIt first: an iterator to the first element in the range to sort
+     *  - RandomIt last: an iterator to one past the end of the range to sort
+     *  - Compare comp: the comparison function object to be used in sorting
+     *  - enum shellseq gapseq: the gap sequence to use in sorting
+     *      [default: curia01]
+     */
+    template <typename TaskSystem, typename RandomIt, typename Compare>
+    void shellsort (
+        execution::parallel_policy, TaskSystem & tasks,
+        RandomIt first, RandomIt last, Compare comp,
+        enum shellseq seq = shellseq::curia01
+    )
+    {
+        auto const index {first};
+        auto const length {static_cast <std::size_t> (last - first)};
+
+        /* short ranges do not repay the scheduling overhead */
+        if (length < 4096) {
+            return shellsort (first, last, comp, seq);
+        }
+
+        std::vector <std::size_t> gaps;
+        switch (seq) {
+            case shellseq::curia01:
+                gaps.assign (curia01_seq.begin (), curia01_seq.end ());
+                break;
+            case shellseq::tokuda92:
+                gaps.assign (tokuda92_seq.begin (), tokuda92_seq.end ());
+                break;
+            case shellseq::sedgewick86:
+                gaps.assign (sedgewick86_seq.begin (), sedgewick86_seq.end ());
+                break;
+        }
+
+        /*
+         * insertion sorts the chains c0, ..., c1 - 1 of the given gap; the
+         * chain of index c comprises the elements c, c + g, c + 2g, ...
+         */
+        auto const chain_sort {
+            [index, length, comp] (std::size_t g, std::size_t c0,
+                                   std::size_t c1)
+            {
+                for (std::size_t c = c0; c < c1; ++c) {
+                    for (std::size_t i = c + g; i < length; i += g) {
+                        auto const tmp {index [i]};
+
+                        std::size_t j;
+                        for (j = i; j >= g && comp (tmp, index [j - g]);
+                             j -= g)
+                        {
+                            index [j] = index [j - g];
+                        }
+
+                        index [j] = tmp;
+                    }
+                }
+            }
+        };
+
+        auto const width {
+            static_cast <std::size_t> (
+                std::max (1u, std::thread::hardware_concurrency ())
+            )
+        };
+
+        std::vector <std::future <void>> pass;
+
+        for (std::size_t g : gaps) {
+            auto const ntasks {std::min <std::size_t> (g, 4 * width)};
+
+            if (ntasks < 2) {
+                chain_sort (g, 0, g);
+                continue;
+            }
+
+            for (std::size_t t = 0; t < ntasks; ++t) {
+                auto const c0 {(t * g) / ntasks};
+                auto const c1 {((t + 1) * g) / ntasks};
+
+                pass.emplace_back (tasks.push (
+                    [chain_sort, g, c0, c1] { chain_sort (g, c0, c1); }
+                ));
+            }
+
+            for (auto & f : pass) { f.get (); }
+            pass.clear ();
+        }
+    }
+
+    template <typename TaskSystem, typename RandomIt>
+    void shellsort (
+        execution::parallel_policy policy, TaskSystem & tasks,
+        RandomIt first, RandomIt last, enum shellseq seq = shellseq::curia01
+    )
+    {
+        using value_type = typename std::iterator_traits <RandomIt>::value_type;
+        shellsort (policy, tasks, first, last, std::less <value_type> {}, seq);
+    }
 }   // namespace dsa
 
 #endif  // #ifndef DSA_SORTING_BLOCKSORT_HPP
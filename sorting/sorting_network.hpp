@@ -0,0 +1,194 @@
+//
+// dsa is a utility library of data structures and algorithms built with C++11.
+// This file (sorting_network.hpp) is part of the dsa project.
+//
+// sorting_network; branchless fixed-size sorting kernels used as the small
+// array base case of the sorting algorithms.
+//
+// A description of sorting networks can be found here:
+//
+//      https://en.wikipedia.org/wiki/Sorting_network
+//
+// author: Dalton Woodard
+// contact: daltonmwoodard@gmail.com
+// repository: https://github.com/daltonwoodard/sorting.git
+// license:
+//
+// Copyright (c) 2016 Dalton Woodard. See the COPYRIGHT.md file at the top-level
+// directory or at the listed source repository for details.
+//
+//      Licensed under the Apache License. Version 2.0:
+//          https://www.apache.org/licenses/LICENSE-2.0
+//      or the MIT License:
+//          https://opensource.org/licenses/MIT
+//      at the licensee's option. This file may not be copied, modified, or
+//      distributed except according to those terms.
+//
+
+#ifndef DSA_SORTING_SORTING_NETWORK_HPP
+#define DSA_SORTING_SORTING_NETWORK_HPP
+
+#include <functional>   // std::less
+#include <type_traits>  // std::is_arithmetic, std::is_same
+
+
+namespace dsa
+{
+namespace detail
+{
+    /*
+     * decides whether ranges of T under the comparator Compare may be
+     * sorted by the network kernels below; the kernels encode the default
+     * ascending order directly in their compare-exchanges, so they apply
+     * exactly to arithmetic element types compared with std::less.
+     */
+    template <typename T, typename Compare>
+    struct use_sorting_network : std::integral_constant <
+        bool,
+        std::is_arithmetic <T>::value &&
+            std::is_same <Compare, std::less <T>>::value
+    > {};
+
+    /*
+     * branchless compare-exchange: after the call a holds the smaller and b
+     * the larger of the two values. Written as conditional moves rather
+     * than a swap so that, over the unrolled body of a network, compilers
+     * lower consecutive exchanges to (vector) min/max instructions on
+     * arithmetic types.
+     */
+    template <typename T>
+    inline void cswap (T & a, T & b) noexcept
+    {
+        T const lo = a < b ? a : b;
+        T const hi = a < b ? b : a;
+        a = lo;
+        b = hi;
+    }
+
+    /*
+     * the networks below are Batcher odd-even merge networks of 5, 19, and
+     * 63 compare-exchanges respectively, grouped by dependency layer;
+     * exchanges within one group touch disjoint indices and so may execute
+     * in parallel (in particular, within vector lanes).
+     */
+    template <typename RandomIt>
+    inline void network_sort_4 (RandomIt a)
+    {
+        cswap (a [0], a [1]);
+        cswap (a [2], a [3]);
+
+        cswap (a [0], a [2]);
+        cswap (a [1], a [3]);
+
+        cswap (a [1], a [2]);
+    }
+
+    template <typename RandomIt>
+    inline void network_sort_8 (RandomIt a)
+    {
+        cswap (a [0], a [1]);
+        cswap (a [2], a [3]);
+        cswap (a [4], a [5]);
+        cswap (a [6], a [7]);
+
+        cswap (a [0], a [2]);
+        cswap (a [1], a [3]);
+        cswap (a [4], a [6]);
+        cswap (a [5], a [7]);
+
+        cswap (a [1], a [2]);
+        cswap (a [5], a [6]);
+        cswap (a [0], a [4]);
+
+        cswap (a [1], a [5]);
+        cswap (a [2], a [6]);
+        cswap (a [3], a [7]);
+
+        cswap (a [2], a [4]);
+        cswap (a [3], a [5]);
+
+        cswap (a [1], a [2]);
+        cswap (a [3], a [4]);
+        cswap (a [5], a [6]);
+    }
+
+    template <typename RandomIt>
+    inline void network_sort_16 (RandomIt a)
+    {
+        cswap (a [0], a [1]);
+        cswap (a [2], a [3]);
+        cswap (a [4], a [5]);
+        cswap (a [6], a [7]);
+        cswap (a [8], a [9]);
+        cswap (a [10], a [11]);
+        cswap (a [12], a [13]);
+        cswap (a [14], a [15]);
+
+        cswap (a [0], a [2]);
+        cswap (a [1], a [3]);
+        cswap (a [4], a [6]);
+        cswap (a [5], a [7]);
+        cswap (a [8], a [10]);
+        cswap (a [9], a [11]);
+        cswap (a [12], a [14]);
+        cswap (a [13], a [15]);
+
+        cswap (a [1], a [2]);
+        cswap (a [5], a [6]);
+        cswap (a [9], a [10]);
+        cswap (a [13], a [14]);
+        cswap (a [0], a [4]);
+
+        cswap (a [1], a [5]);
+        cswap (a [2], a [6]);
+        cswap (a [3], a [7]);
+        cswap (a [8], a [12]);
+        cswap (a [9], a [13]);
+        cswap (a [10], a [14]);
+        cswap (a [11], a [15]);
+
+        cswap (a [2], a [4]);
+        cswap (a [3], a [5]);
+        cswap (a [10], a [12]);
+        cswap (a [11], a [13]);
+
+        cswap (a [1], a [2]);
+        cswap (a [3], a [4]);
+        cswap (a [5], a [6]);
+        cswap (a [9], a [10]);
+        cswap (a [11], a [12]);
+        cswap (a [13], a [14]);
+        cswap (a [0], a [8]);
+
+        cswap (a [1], a [9]);
+        cswap (a [2], a [10]);
+        cswap (a [3], a [11]);
+        cswap (a [4], a [12]);
+        cswap (a [5], a [13]);
+        cswap (a [6], a [14]);
+        cswap (a [7], a [15]);
+
+        cswap (a [4], a [8]);
+        cswap (a [5], a [9]);
+        cswap (a [6], a [10]);
+        cswap (a [7], a [11]);
+
+        cswap (a [2], a [4]);
+        cswap (a [3], a [5]);
+        cswap (a [6], a [8]);
+        cswap (a [7], a [9]);
+        cswap (a [10], a [12]);
+        cswap (a [11], a [13]);
+
+        cswap (a [1], a [2]);
+        cswap (a [3], a [4]);
+        cswap (a [5], a [6]);
+        cswap (a [7], a [8]);
+        cswap (a [9], a [10]);
+        cswap (a [11], a [12]);
+        cswap (a [13], a [14]);
+    }
+}   // namespace detail
+}   // namespace dsa
+
+#endif  // #ifndef DSA_SORTING_SORTING_NETWORK_HPP
@@ -29,6 +29,7 @@
 
 #include <atomic>       // std::atomic_flag, std::memory_order_{acquire,release}
 #include <chrono>       // std::chrono::duration
+#include <cstddef>      // std::size_t
 #include <thread>       // std::this_thread::yield
 #include <type_traits>  // std::common_type
 
@@ -99,6 +100,11 @@ namespace dsa
      *  depending on the success of the call.
      *
      *  - unlock: unlocks the spinlock.
+     *
+     * When compiled with DSA_SPINLOCK_STATS defined the spinlock
+     * additionally counts spin iterations and yields, readable through
+     * snapshot; without the flag the counters do not exist and lock is
+     * unchanged.
      */
     template <
         typename WaitDurationType,
@@ -124,6 +130,11 @@ namespace dsa
         /* guaranteed initialization to false */
         std::atomic_flag lock_flag = ATOMIC_FLAG_INIT;
 
+#ifdef DSA_SPINLOCK_STATS
+        std::atomic <std::size_t> stat_spins_ {0};
+        std::atomic <std::size_t> stat_yields_ {0};
+#endif
+
     public:
         constexpr spinlock (void) noexcept = default;
         ~spinlock (void) noexcept          = default;
@@ -140,6 +151,11 @@ namespace dsa
                 auto const start {std::chrono::steady_clock::now ()};
 
                 while (lock_flag.test_and_set (std::memory_order_acquire)) {
+#ifdef DSA_SPINLOCK_STATS
+                    this->stat_spins_.fetch_add (
+                        1, std::memory_order_relaxed
+                    );
+#endif
                     auto const now {std::chrono::steady_clock::now ()};
                     auto const elapsed {
                         std::chrono::duration_cast <duration_type> (now - start)
@@ -152,6 +168,9 @@ namespace dsa
 
                 return;
             yield:
+#ifdef DSA_SPINLOCK_STATS
+                this->stat_yields_.fetch_add (1, std::memory_order_relaxed);
+#endif
                 std::this_thread::yield ();
             }
         }
@@ -165,6 +184,403 @@ namespace dsa
         {
             lock_flag.clear (std::memory_order_release);
         }
+
+#ifdef DSA_SPINLOCK_STATS
+        /*
+         * Instrumentation snapshot, available when the library is compiled
+         * with DSA_SPINLOCK_STATS defined; without the flag none of the
+         * counters (or this interface) exist and lock is untouched.
+         */
+        struct stats
+        {
+            /* failed test_and_set attempts inside lock */
+            std::size_t spin_iterations;
+
+            /* yields after exhausting a busy-wait period */
+            std::size_t yields;
+        };
+
+        stats snapshot (void) const noexcept
+        {
+            return stats {
+                this->stat_spins_.load (std::memory_order_relaxed),
+                this->stat_yields_.load (std::memory_order_relaxed)
+            };
+        }
+#endif
+    };
+
+    /* out-of-line definition; required in C++11, where the in-class
+     * initializer alone is not a definition and the default argument of
+     * lock odr-uses the member. */
+    template <
+        typename WaitDurationType,
+        typename WaitDurationType::rep wait_count
+    >
+    constexpr typename spinlock <WaitDurationType, wait_count>::duration_type
+        spinlock <WaitDurationType, wait_count>::default_wait_time;
+
+namespace detail
+{
+    /*
+     * a hint to the processor that the calling thread is in a spin-wait
+     * loop; unlike std::this_thread::yield this does not enter the kernel,
+     * it merely de-prioritizes the core's pipeline (and, on some
+     * architectures, releases shared execution resources to a sibling
+     * hardware thread) for a few cycles.
+     */
+    inline void cpu_relax (void) noexcept
+    {
+#if defined (__i386__) || defined (__x86_64__)
+        __builtin_ia32_pause ();
+#elif defined (__aarch64__) || defined (__arm__)
+        asm volatile ("yield" ::: "memory");
+#else
+        /* no pause instruction available; settle for a compiler barrier */
+        std::atomic_signal_fence (std::memory_order_seq_cst);
+#endif
+    }
+}   // namespace detail
+
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::backoff_spinlock is a busy-wait synchronization primitive with the
+     * same semantics as dsa::spinlock<>, designed to stay cheap under
+     * contention.
+     *
+     * Two techniques distinguish it from dsa::spinlock<>:
+     *
+     *  - test-and-test-and-set: a waiting thread spins on plain loads of the
+     *  lock word, which hit the local cache, and attempts the exchange only
+     *  once the lock has been observed free. The cache line holding the lock
+     *  therefore stays in the shared state while the lock is held, instead of
+     *  bouncing between every waiter's cache on each test_and_set.
+     *
+     *  - exponential backoff: between observations a waiter pauses for a
+     *  doubling number of cpu_relax iterations (bounded above), so under
+     *  heavy contention most waiters are paused rather than loading the lock
+     *  word, and the spin path makes no clock calls at all.
+     *
+     * A dsa::backoff_spinlock is compatible with std::unique_lock<> and
+     * std::lock_guard<> objects, and is neither copyable nor movable.
+     *
+     * Acquisition order is unspecified; if fairness between waiters is
+     * required, see dsa::ticket_spinlock.
+     *
+     * Member Functions
+     * ----------------
+     *
+     *  - backoff_spinlock: constructs the spinlock.
+     *
+     *  - ~backoff_spinlock: destroys the spinlock.
+     *
+     *  - lock: locks the spinlock, blocking if the spinlock is not available.
+     *
+     *  - try_lock: tries to lock the spinlock, returns a boolean value
+     *  depending on the success of the call.
+     *
+     *  - unlock: unlocks the spinlock.
+     */
+    class backoff_spinlock
+    {
+        /* bounds on the number of cpu_relax iterations between tests */
+        static constexpr unsigned min_backoff = 4;
+        static constexpr unsigned max_backoff = 1024;
+
+        /*
+         * a plain atomic boolean rather than a std::atomic_flag; the
+         * test-and-test-and-set loop requires loads that do not modify the
+         * lock word, which std::atomic_flag cannot express in C++11.
+         */
+        std::atomic <bool> lock_flag {false};
+
+    public:
+        constexpr backoff_spinlock (void) noexcept = default;
+        ~backoff_spinlock (void) noexcept          = default;
+
+        backoff_spinlock (backoff_spinlock &&)      = delete;
+        backoff_spinlock (backoff_spinlock const &) = delete;
+
+        backoff_spinlock & operator= (backoff_spinlock &&)      = delete;
+        backoff_spinlock & operator= (backoff_spinlock const &) = delete;
+
+        void lock (void) & noexcept
+        {
+            auto backoff = min_backoff;
+
+            while (true) {
+                if (!lock_flag.exchange (true, std::memory_order_acquire)) {
+                    return;
+                }
+
+                while (lock_flag.load (std::memory_order_relaxed)) {
+                    for (auto i = 0u; i < backoff; ++i) {
+                        detail::cpu_relax ();
+                    }
+
+                    if (backoff < max_backoff) {
+                        backoff <<= 1;
+                    }
+                }
+            }
+        }
+
+        bool try_lock (void) & noexcept
+        {
+            return !lock_flag.load (std::memory_order_relaxed) &&
+                   !lock_flag.exchange (true, std::memory_order_acquire);
+        }
+
+        void unlock (void) & noexcept
+        {
+            lock_flag.store (false, std::memory_order_release);
+        }
+    };
+
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::ticket_spinlock is a busy-wait synchronization primitive with the
+     * same semantics as dsa::spinlock<> that additionally guarantees FIFO
+     * fairness: threads acquire the lock in exactly the order in which their
+     * lock calls arrived, so no waiter can be starved by later arrivals.
+     *
+     * A thread draws a ticket by atomically incrementing the tail counter,
+     * then spins until the now-serving counter reaches its ticket; unlock
+     * advances the now-serving counter by one, handing the lock to the next
+     * ticket in line. Waiters spin on loads of the now-serving counter with
+     * cpu_relax between observations; no clock calls are made on the spin
+     * path.
+     *
+     * A dsa::ticket_spinlock is compatible with std::unique_lock<> and
+     * std::lock_guard<> objects, and is neither copyable nor movable.
+     *
+     * Member Functions
+     * ----------------
+     *
+     *  - ticket_spinlock: constructs the spinlock.
+     *
+     *  - ~ticket_spinlock: destroys the spinlock.
+     *
+     *  - lock: locks the spinlock, blocking if the spinlock is not available.
+     *
+     *  - try_lock: tries to lock the spinlock, returns a boolean value
+     *  depending on the success of the call.
+     *
+     *  - unlock: unlocks the spinlock.
+     */
+    class ticket_spinlock
+    {
+        std::atomic <std::size_t> next_ticket {0};
+        std::atomic <std::size_t> now_serving {0};
+
+    public:
+        constexpr ticket_spinlock (void) noexcept = default;
+        ~ticket_spinlock (void) noexcept          = default;
+
+        ticket_spinlock (ticket_spinlock &&)      = delete;
+        ticket_spinlock (ticket_spinlock const &) = delete;
+
+        ticket_spinlock & operator= (ticket_spinlock &&)      = delete;
+        ticket_spinlock & operator= (ticket_spinlock const &) = delete;
+
+        void lock (void) & noexcept
+        {
+            auto const ticket = next_ticket.fetch_add (
+                1, std::memory_order_relaxed
+            );
+
+            while (now_serving.load (std::memory_order_acquire) != ticket) {
+                detail::cpu_relax ();
+            }
+        }
+
+        bool try_lock (void) & noexcept
+        {
+            auto const serving = now_serving.load (std::memory_order_acquire);
+            auto expected = serving;
+
+            /*
+             * the lock is free exactly when the tail equals the now-serving
+             * counter; claim the front ticket only in that case, so a failed
+             * try_lock neither blocks nor takes a place in line.
+             */
+            return next_ticket.compare_exchange_strong (
+                expected, serving + 1,
+                std::memory_order_acquire, std::memory_order_relaxed
+            );
+        }
+
+        void unlock (void) & noexcept
+        {
+            now_serving.fetch_add (1, std::memory_order_release);
+        }
+    };
+
+    /*
+     * Description
+     * -----------
+     *
+     * dsa::shared_spinlock<> is a busy-wait shared/exclusive synchronization
+     * primitive for data that is read far more often than it is written.
+     * Any number of threads may hold the lock in shared mode concurrently;
+     * exclusive mode excludes readers and other writers alike.
+     *
+     * The entire lock state lives in a single atomic word: one bit records
+     * an active writer, one bit records that a writer is waiting, and the
+     * remaining bits count the active readers. Readers enter by a single
+     * compare-exchange incrementing the count; a writer acquires by a single
+     * compare-exchange when the count is zero. Waiters spin with cpu_relax
+     * between observations; no clock calls are made on any spin path.
+     *
+     * Template Parameters
+     * -------------------
+     *
+     *  - prefer_writers: when true (the default), a waiting writer blocks
+     *  the entry of new readers, so writers cannot be starved by a
+     *  continuous stream of overlapping readers; active readers always
+     *  drain first. When false, readers enter whenever no writer is
+     *  active, which favors reader throughput at the risk of writer
+     *  starvation.
+     *
+     * Member Functions
+     * ----------------
+     *
+     *  - shared_spinlock: constructs the spinlock.
+     *
+     *  - ~shared_spinlock: destroys the spinlock.
+     *
+     *  - lock/try_lock/unlock: acquire and release exclusive ownership;
+     *  these match the BasicLockable interface, so the exclusive side is
+     *  compatible with std::unique_lock<> and std::lock_guard<> objects.
+     *
+     *  - lock_shared/try_lock_shared/unlock_shared: acquire and release
+     *  shared ownership; these match the SharedMutex interface, so the
+     *  shared side is compatible with std::shared_lock<> where available
+     *  (C++14 and later).
+     */
+    template <bool prefer_writers = true>
+    class shared_spinlock
+    {
+        static constexpr std::size_t writer_active  = 1;
+        static constexpr std::size_t writer_waiting = 2;
+        static constexpr std::size_t reader_unit    = 4;
+
+        /*
+         * readers may not enter while a writer is active, nor (under writer
+         * preference) while one is waiting.
+         */
+        static constexpr std::size_t reader_blocked =
+            prefer_writers ? writer_active | writer_waiting
+                           : writer_active;
+
+        std::atomic <std::size_t> state {0};
+
+    public:
+        constexpr shared_spinlock (void) noexcept = default;
+        ~shared_spinlock (void) noexcept          = default;
+
+        shared_spinlock (shared_spinlock &&)      = delete;
+        shared_spinlock (shared_spinlock const &) = delete;
+
+        shared_spinlock & operator= (shared_spinlock &&)      = delete;
+        shared_spinlock & operator= (shared_spinlock const &) = delete;
+
+        void lock (void) & noexcept
+        {
+            while (true) {
+                auto s = state.load (std::memory_order_relaxed);
+
+                if (s == 0 || s == writer_waiting) {
+                    /*
+                     * no active readers and no active writer; claiming the
+                     * lock clears the waiting bit, which any other waiting
+                     * writer re-asserts on its next observation.
+                     */
+                    if (state.compare_exchange_weak (
+                            s, writer_active,
+                            std::memory_order_acquire,
+                            std::memory_order_relaxed
+                        ))
+                    {
+                        return;
+                    }
+                } else if (prefer_writers && !(s & writer_waiting)) {
+                    state.fetch_or (
+                        writer_waiting, std::memory_order_relaxed
+                    );
+                } else {
+                    detail::cpu_relax ();
+                }
+            }
+        }
+
+        bool try_lock (void) & noexcept
+        {
+            auto s = state.load (std::memory_order_relaxed);
+
+            return (s == 0 || s == writer_waiting) &&
+                state.compare_exchange_strong (
+                    s, writer_active,
+                    std::memory_order_acquire, std::memory_order_relaxed
+                );
+        }
+
+        void unlock (void) & noexcept
+        {
+            /*
+             * the waiting bit may have been set by other writers while this
+             * one held the lock, so clear only the active bit.
+             */
+            state.fetch_and (
+                ~writer_active, std::memory_order_release
+            );
+        }
+
+        void lock_shared (void) & noexcept
+        {
+            while (true) {
+                auto s = state.load (std::memory_order_relaxed);
+
+                if (!(s & reader_blocked)) {
+                    if (state.compare_exchange_weak (
+                            s, s + reader_unit,
+                            std::memory_order_acquire,
+                            std::memory_order_relaxed
+                        ))
+                    {
+                        return;
+                    }
+                } else {
+                    detail::cpu_relax ();
+                }
+            }
+        }
+
+        bool try_lock_shared (void) & noexcept
+        {
+            auto s = state.load (std::memory_order_relaxed);
+
+            while (!(s & reader_blocked)) {
+                if (state.compare_exchange_weak (
+                        s, s + reader_unit,
+                        std::memory_order_acquire, std::memory_order_relaxed
+                    ))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void unlock_shared (void) & noexcept
+        {
+            state.fetch_sub (reader_unit, std::memory_order_release);
+        }
     };
 } // namespace dsa
 
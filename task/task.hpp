@@ -23,7 +23,6 @@
 
 #include <algorithm>
 #include <atomic>
-#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
@@ -32,10 +31,12 @@
 #include <future>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <queue>
 #include <thread>
 #include <utility>
 #include <vector>
+#include "mpmc_ringbuffer.hpp"
 #include "utilities/functions.hpp"
 #include "utilities/sequence.hpp"
 #include "utilities/traits.hpp"
@@ -56,28 +57,58 @@ namespace dsa
     class task
     {
     public:
-        task (void) = default;
-        ~task (void) = default;
+        task (void) noexcept
+            : _t (nullptr)
+        {}
+
+        ~task (void)
+        {
+            this->reset_ ();
+        }
 
         task (task const &) = delete;
-        task (task &&) noexcept = default;
+
+        task (task && other) noexcept
+            : _t (nullptr)
+        {
+            this->adopt_ (other);
+        }
 
         task & operator= (task const &) = delete;
-        task & operator= (task &&) noexcept = default;
+
+        task & operator= (task && other) noexcept
+        {
+            if (this != &other) {
+                this->reset_ ();
+                this->adopt_ (other);
+            }
+
+            return *this;
+        }
 
         void swap (task & other) noexcept
         {
-            std::swap (this->_t, other._t);
+            task tmp (std::move (other));
+            other = std::move (*this);
+            *this = std::move (tmp);
         }
 
         operator bool (void) const noexcept
         {
-            return static_cast <bool> (this->_t);
+            return this->_t != nullptr;
         }
 
         template <class>
         friend class task_system;
 
+        template <class F, class ... Args>
+        friend task make_detached_task (F && f, Args && ... args);
+
+        template <class Allocator, class F, class ... Args>
+        friend task make_detached_task (std::allocator_arg_t,
+                                        Allocator const & alloc,
+                                        F && f, Args && ... args);
+
         template <class F, class ... Args>
         friend std::pair <
             task,  std::future <typename std::result_of <F (Args...)>::type>
@@ -125,31 +156,70 @@ namespace dsa
         }
 
     private:
+        struct detached_tag {};
+
         template <class F, class ... Args>
         task (F && f, Args && ... args)
-            : _t (
-                new task_model <
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                task_model <
                     typename std::result_of <F (Args...)>::type (Args...)
-                > (std::forward <F> (f), std::forward <Args> (args)...)
-            )
-        {}
+                >
+            > (std::forward <F> (f), std::forward <Args> (args)...);
+        }
 
         template <class Allocator, class F, class ... Args>
         task (std::allocator_arg_t,
               Allocator const & alloc,
               F && f, Args && ... args)
-            : _t (
-                new task_model <
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                task_model <
                     typename std::result_of <F (Args...)>::type (Args...)
-                > (std::allocator_arg_t (), alloc,
-                   std::forward <F> (f), std::forward <Args> (args)...)
-            )
-        {}
+                >
+            > (std::allocator_arg_t (), alloc,
+               std::forward <F> (f), std::forward <Args> (args)...);
+        }
+
+        template <class F, class ... Args>
+        task (detached_tag, F && f, Args && ... args)
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                detached_task_model <typename std::decay <F>::type, Args...>
+            > (std::forward <F> (f), std::forward <Args> (args)...);
+        }
+
+        template <class Allocator, class F, class ... Args>
+        task (detached_tag,
+              std::allocator_arg_t,
+              Allocator const & alloc,
+              F && f, Args && ... args)
+            : _t (nullptr)
+        {
+            this->emplace_ <
+                detached_task_model <typename std::decay <F>::type, Args...>
+            > (std::allocator_arg_t (), alloc,
+               std::forward <F> (f), std::forward <Args> (args)...);
+        }
 
         struct task_concept
         {
             virtual ~task_concept (void) noexcept {}
             virtual void invoke_ (void) = 0;
+
+            /*
+             * relocates the model into the given small-buffer storage,
+             * returning its new location; called only for models selected
+             * for in-object placement, which are nothrow move
+             * constructible by construction.
+             */
+            virtual task_concept * move_into_ (void * storage) noexcept = 0;
+
+            /* relocates the model onto the heap */
+            virtual task_concept * move_to_heap_ (void) = 0;
         };
 
         template <class> struct task_model;
@@ -178,103 +248,854 @@ namespace dsa
                          std::forward <Args> (args)...)
             {}
 
+            std::future <R> get_future (void)
+            {
+                return this->_f.get_future ();
+            }
+
             void invoke_ (void) override
             {
                 utility::apply (this->_f, this->_args);
             }
 
+            task_concept * move_into_ (void * storage) noexcept override
+            {
+                return new (storage) task_model (std::move (*this));
+            }
+
+            task_concept * move_to_heap_ (void) override
+            {
+                return new task_model (std::move (*this));
+            }
+
         private:
             std::packaged_task <R (Args...)> _f;
             std::tuple <Args...> _args;
         };
 
-        std::unique_ptr <task_concept> _t;
+        /*
+         * a task_model without the packaged_task machinery; invoking the
+         * stored callable directly saves the future shared state when no
+         * result will ever be observed.
+         */
+        template <class F, class ... Args>
+        struct detached_task_model : task_concept
+        {
+            template <class G>
+            explicit detached_task_model (G && g, Args && ... args)
+                : _f    (std::forward <G> (g))
+                , _args (std::forward <Args> (args)...)
+            {}
+
+            template <class Allocator, class G>
+            explicit detached_task_model (
+                std::allocator_arg_t, Allocator const & alloc,
+                G && g, Args && ... args
+            )
+                : _f    (std::forward <G> (g))
+                , _args (std::allocator_arg_t (), alloc,
+                         std::forward <Args> (args)...)
+            {}
+
+            void invoke_ (void) override
+            {
+                utility::apply (this->_f, this->_args);
+            }
+
+            task_concept * move_into_ (void * storage) noexcept override
+            {
+                return new (storage) detached_task_model (std::move (*this));
+            }
+
+            task_concept * move_to_heap_ (void) override
+            {
+                return new detached_task_model (std::move (*this));
+            }
+
+        private:
+            F _f;
+            std::tuple <Args...> _args;
+        };
+
+        /*
+         * adopts a type-erased model previously released from another task;
+         * used by task_system to pass ownership through its work-stealing
+         * deques, which hold raw pointers. The model is always heap
+         * allocated (see release_).
+         */
+        explicit task (task_concept * model) noexcept
+            : _t (model)
+        {}
+
+        /*
+         * models at most this large (and no more strictly aligned than
+         * std::max_align_t) are constructed in the in-object buffer rather
+         * than on the heap; the bound comfortably fits the common case of a
+         * packaged_task plus a few bound arguments.
+         */
+        static constexpr std::size_t small_buffer_size = 64;
+
+        template <class Model>
+        static constexpr bool fits_small_buffer_ (void)
+        {
+            /*
+             * only nothrow move constructible models are placed in the
+             * buffer, so that moving a task can remain noexcept.
+             */
+            return sizeof (Model) <= small_buffer_size &&
+                   alignof (Model) <= alignof (std::max_align_t) &&
+                   std::is_nothrow_move_constructible <Model>::value;
+        }
+
+        bool small_ (void) const noexcept
+        {
+            return static_cast <void const *> (this->_t) ==
+                   static_cast <void const *> (&this->_storage);
+        }
+
+        /* dispatch on the fit so only the taken branch is instantiated */
+        template <class Model, class ... Ts>
+        void emplace_ (Ts && ... ts)
+        {
+            this->emplace_impl_ <Model> (
+                std::integral_constant <
+                    bool, fits_small_buffer_ <Model> ()
+                > {},
+                std::forward <Ts> (ts)...
+            );
+        }
+
+        template <class Model, class ... Ts>
+        void emplace_impl_ (std::true_type, Ts && ... ts)
+        {
+            this->_t = new (static_cast <void *> (&this->_storage))
+                Model (std::forward <Ts> (ts)...);
+        }
+
+        template <class Model, class ... Ts>
+        void emplace_impl_ (std::false_type, Ts && ... ts)
+        {
+            this->_t = new Model (std::forward <Ts> (ts)...);
+        }
+
+        void reset_ (void) noexcept
+        {
+            if (this->_t) {
+                if (this->small_ ())
+                    this->_t->~task_concept ();
+                else
+                    delete this->_t;
+
+                this->_t = nullptr;
+            }
+        }
+
+        /* takes over other's model, relocating it if it lives in-object */
+        void adopt_ (task & other) noexcept
+        {
+            if (!other._t) {
+                this->_t = nullptr;
+            } else if (other.small_ ()) {
+                this->_t = other._t->move_into_ (
+                    static_cast <void *> (&this->_storage)
+                );
+                other.reset_ ();
+            } else {
+                this->_t = other._t;
+                other._t = nullptr;
+            }
+        }
+
+        /*
+         * hands the model out as a raw heap pointer (promoting it from the
+         * small buffer if necessary) for transport through the
+         * work-stealing deques.
+         */
+        task_concept * release_ (void)
+        {
+            if (!this->_t)
+                return nullptr;
+
+            if (this->small_ ()) {
+                auto const model = this->_t->move_to_heap_ ();
+                this->reset_ ();
+                return model;
+            }
+
+            auto const model = this->_t;
+            this->_t = nullptr;
+            return model;
+        }
+
+        task_concept * _t;
+        typename std::aligned_storage <
+            small_buffer_size, alignof (std::max_align_t)
+        >::type _storage;
+    };
+
+    /*
+     * Creates a fire-and-forget task from the provided callable and
+     * arguments; unlike make_task, no future to the result is created (and
+     * so no shared state is allocated), which is the cheaper choice when
+     * the result is never observed.
+     */
+    template <class F, class ... Args>
+    task make_detached_task (F && f, Args && ... args)
+    {
+        return task (
+            task::detached_tag (),
+            std::forward <F> (f), std::forward <Args> (args)...
+        );
+    }
+
+    template <class Allocator, class F, class ... Args>
+    task make_detached_task (std::allocator_arg_t,
+                             Allocator const & alloc,
+                             F && f, Args && ... args)
+    {
+        return task (
+            task::detached_tag (), std::allocator_arg_t (), alloc,
+            std::forward <F> (f), std::forward <Args> (args)...
+        );
+    }
+
+    /*
+     * work_stealing_deque; a lock-free deque after Chase and Lev ("Dynamic
+     * Circular Work-Stealing Deque", SPAA 2005), with the memory ordering
+     * treatment of Le et al. ("Correct and Efficient Work-Stealing for
+     * Weak Memory Models", PPoPP 2013).
+     *
+     * The owning thread pushes and pops LIFO at the bottom with plain atomic
+     * loads and stores plus a single fence, while any number of thief
+     * threads steal FIFO from the top with one compare-and-swap; only the
+     * race for the last remaining element is ever contended. The deque
+     * stores trivially copyable handles (raw pointers in practice) by value
+     * and value-initialized T is returned as the "empty" result; it does
+     * not own what the handles point to.
+     *
+     * The backing circular array grows by doubling when full; retired
+     * arrays are kept on a chain until destruction, since a concurrent
+     * thief may still be reading from one.
+     */
+    template <class T>
+    class work_stealing_deque
+    {
+        static_assert (
+            std::is_trivially_copyable <T>::value,
+            "work_stealing_deque elements must be trivially copyable handles"
+        );
+
+        static constexpr std::size_t cacheline_size = 64;
+        static constexpr std::size_t initial_capacity = 64;
+
+        struct circular_array
+        {
+            std::size_t capacity;
+            circular_array * retired;
+            std::unique_ptr <std::atomic <T> []> slots;
+
+            explicit circular_array (std::size_t cap)
+                : capacity {cap}
+                , retired  {nullptr}
+                , slots    {new std::atomic <T> [cap] ()}
+            {}
+
+            T get (std::ptrdiff_t index) const noexcept
+            {
+                return this->slots [
+                    static_cast <std::size_t> (index) & (this->capacity - 1)
+                ].load (std::memory_order_relaxed);
+            }
+
+            void put (std::ptrdiff_t index, T t) noexcept
+            {
+                this->slots [
+                    static_cast <std::size_t> (index) & (this->capacity - 1)
+                ].store (t, std::memory_order_relaxed);
+            }
+        };
+
+        alignas (cacheline_size) std::atomic <std::ptrdiff_t> _top;
+        alignas (cacheline_size) std::atomic <std::ptrdiff_t> _bottom;
+        std::atomic <circular_array *> _array;
+
+        /*
+         * installs a doubled array holding [top, bottom), retiring the old
+         * one; called by the owner only.
+         */
+        void grow (circular_array * a,
+                   std::ptrdiff_t bottom,
+                   std::ptrdiff_t top)
+        {
+            auto const bigger = new circular_array (2 * a->capacity);
+
+            for (auto i = top; i != bottom; ++i) {
+                bigger->put (i, a->get (i));
+            }
+
+            bigger->retired = a;
+            this->_array.store (bigger, std::memory_order_release);
+        }
+
+    public:
+        work_stealing_deque (void)
+            : _top    {0}
+            , _bottom {0}
+            , _array  {new circular_array (initial_capacity)}
+        {}
+
+        work_stealing_deque (work_stealing_deque const &) = delete;
+        work_stealing_deque & operator= (work_stealing_deque const &) = delete;
+
+        /*
+         * moves are permitted only before any concurrent use; task_system
+         * moves its deques while setting up, never afterwards.
+         */
+        work_stealing_deque (work_stealing_deque && other) noexcept
+            : _top    {other._top.load (std::memory_order_relaxed)}
+            , _bottom {other._bottom.load (std::memory_order_relaxed)}
+            , _array  {other._array.exchange (
+                  nullptr, std::memory_order_relaxed
+              )}
+        {}
+
+        ~work_stealing_deque (void) noexcept
+        {
+            auto a = this->_array.load (std::memory_order_relaxed);
+
+            while (a) {
+                auto const retired = a->retired;
+                delete a;
+                a = retired;
+            }
+        }
+
+        /* checks whether the deque appears empty */
+        bool empty (void) const noexcept
+        {
+            return this->_top.load (std::memory_order_acquire) >=
+                   this->_bottom.load (std::memory_order_acquire);
+        }
+
+        /*
+         * Adds a handle at the bottom of the deque, growing the backing
+         * array if necessary. May be called only by the owning thread.
+         */
+        void push_bottom (T t)
+        {
+            auto const b = this->_bottom.load (std::memory_order_relaxed);
+            auto const top = this->_top.load (std::memory_order_acquire);
+            auto a = this->_array.load (std::memory_order_relaxed);
+
+            if (b - top >= static_cast <std::ptrdiff_t> (a->capacity)) {
+                this->grow (a, b, top);
+                a = this->_array.load (std::memory_order_relaxed);
+            }
+
+            a->put (b, t);
+            std::atomic_thread_fence (std::memory_order_release);
+            this->_bottom.store (b + 1, std::memory_order_relaxed);
+        }
+
+        /*
+         * Removes and returns the handle at the bottom of the deque, or a
+         * value-initialized T if the deque is empty. May be called only by
+         * the owning thread.
+         */
+        T pop_bottom (void)
+        {
+            auto const b = this->_bottom.load (std::memory_order_relaxed) - 1;
+            auto const a = this->_array.load (std::memory_order_relaxed);
+
+            this->_bottom.store (b, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+
+            auto top = this->_top.load (std::memory_order_relaxed);
+
+            if (top <= b) {
+                auto t = a->get (b);
+
+                if (top == b) {
+                    /* last element; race any thieves for it */
+                    if (!this->_top.compare_exchange_strong (
+                            top, top + 1,
+                            std::memory_order_seq_cst,
+                            std::memory_order_relaxed
+                        ))
+                    {
+                        t = T {};
+                    }
+
+                    this->_bottom.store (b + 1, std::memory_order_relaxed);
+                }
+
+                return t;
+            } else {
+                this->_bottom.store (b + 1, std::memory_order_relaxed);
+                return T {};
+            }
+        }
+
+        /*
+         * Removes and returns the handle at the top of the deque, or a
+         * value-initialized T if the deque is empty or the race for the top
+         * element was lost. May be called from any thread.
+         */
+        T steal (void)
+        {
+            auto top = this->_top.load (std::memory_order_acquire);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            auto const b = this->_bottom.load (std::memory_order_acquire);
+
+            if (top < b) {
+                /*
+                 * the array must be read after top; if the owner grows the
+                 * array concurrently, the retired array still holds the
+                 * correct handle for this position.
+                 */
+                auto const a = this->_array.load (std::memory_order_acquire);
+                auto const t = a->get (top);
+
+                if (!this->_top.compare_exchange_strong (
+                        top, top + 1,
+                        std::memory_order_seq_cst,
+                        std::memory_order_relaxed
+                    ))
+                {
+                    return T {};
+                }
+
+                return t;
+            }
+
+            return T {};
+        }
+    };
+
+    /*
+     * eventcount parking lot for blocking consumers. A waiter announces
+     * its intent to sleep with prepare_wait, re-checks its wakeup
+     * condition, and only then parks; a producer that signals after the
+     * announcement is guaranteed to observe the waiter, and one that
+     * signaled before it is caught by the re-check, so no wakeup can be
+     * lost. When nobody has announced intent to park, notify_one and
+     * notify_all cost a single atomic load and no system call.
+     *
+     * The state word packs the count of announced waiters in its low half
+     * and a generation counter in its high half; notification bumps the
+     * generation before touching the mutex, which closes the window
+     * between a waiter's final re-check and its wait on the condition
+     * variable.
+     */
+    class eventcount
+    {
+        static constexpr std::uint64_t waiter_one = 1;
+        static constexpr std::uint64_t waiter_mask = 0xffffffffu;
+        static constexpr unsigned generation_shift = 32;
+
+        std::atomic <std::uint64_t> state_ {0};
+        std::mutex mutex_;
+        std::condition_variable cv_;
+
+    public:
+        eventcount (void) = default;
+
+        eventcount (eventcount const &) = delete;
+        eventcount & operator= (eventcount const &) = delete;
+
+        /*
+         * announces the calling thread as a prospective waiter and returns
+         * the generation to pass to wait. The caller must re-check for
+         * work between prepare_wait and wait, and must follow up with
+         * exactly one call to either wait or cancel_wait.
+         */
+        std::uint64_t prepare_wait (void) noexcept
+        {
+            auto const s = this->state_.fetch_add (
+                waiter_one, std::memory_order_seq_cst
+            );
+            return s >> generation_shift;
+        }
+
+        void cancel_wait (void) noexcept
+        {
+            this->state_.fetch_sub (waiter_one, std::memory_order_seq_cst);
+        }
+
+        /* parks until the generation moves past the announced one */
+        void wait (std::uint64_t generation)
+        {
+            {
+                std::unique_lock <std::mutex> lock (this->mutex_);
+                while ((this->state_.load (std::memory_order_seq_cst)
+                            >> generation_shift) == generation)
+                {
+                    this->cv_.wait (lock);
+                }
+            }
+
+            this->state_.fetch_sub (waiter_one, std::memory_order_seq_cst);
+        }
+
+        void notify_one (void)
+        {
+            if ((this->state_.load (std::memory_order_seq_cst)
+                    & waiter_mask) == 0)
+            {
+                return;
+            }
+
+            this->state_.fetch_add (
+                waiter_one << generation_shift, std::memory_order_seq_cst
+            );
+
+            /*
+             * the empty critical section orders the generation bump with
+             * any waiter between its re-check and its cv wait: such a
+             * waiter holds the mutex, so by the time the lock is acquired
+             * here it is either parked (and receives the notification) or
+             * has observed the new generation and returned.
+             */
+            { std::lock_guard <std::mutex> hold (this->mutex_); }
+            this->cv_.notify_one ();
+        }
+
+        void notify_all (void)
+        {
+            if ((this->state_.load (std::memory_order_seq_cst)
+                    & waiter_mask) == 0)
+            {
+                return;
+            }
+
+            this->state_.fetch_add (
+                waiter_one << generation_shift, std::memory_order_seq_cst
+            );
+
+            { std::lock_guard <std::mutex> hold (this->mutex_); }
+            this->cv_.notify_all ();
+        }
     };
 
     /*
      * task_system; a work-stealing tasking system partly inspired by Sean
      * Parent's "Better Code: Concurrency" talk; see http://sean-parent.stlab.cc
+     *
+     * When compiled with DSA_TASK_STATS defined the system additionally
+     * maintains per-worker execution, steal, and blocking counters along
+     * with per-queue high-water marks, readable through snapshot; without
+     * the flag the counters do not exist and the hot paths are unchanged.
      */
     template <class Allocator = std::allocator <task>>
     class task_system
     {
+    public:
+        /*
+         * tasks submitted with priority::high are serviced before
+         * normal-priority work waiting on the same queue; they are not
+         * preemptive and do not overtake tasks already claimed by a worker.
+         */
+        enum priority
+        {
+            normal = 0,
+            high
+        };
+
+        /* returned by current_worker for threads outside the system */
+        static constexpr std::size_t no_affinity =
+            static_cast <std::size_t> (-1);
+
+    private:
+        /*
+         * each queue is a lock-free mpmc_ringbuffer absorbing the common
+         * case, backed by a mutex-guarded overflow queue that only comes
+         * into play when the ring is full; the submission and steal paths
+         * therefore acquire no mutex unless the system is saturated.
+         */
         class task_queue
         {
-            std::queue <task> tasks_;
-            std::condition_variable cv_;
+            static constexpr std::size_t ring_size = 256;
+            static constexpr std::size_t priority_ring_size = 64;
+
+            mpmc_ringbuffer <task, ring_size> ring_;
+            mpmc_ringbuffer <task, priority_ring_size> priority_ring_;
+            std::queue <task> overflow_;
+            std::queue <task> priority_overflow_;
+            eventcount * parked_;
             std::mutex mutex_;
             std::atomic_bool done_ {false};
 
+#ifdef DSA_TASK_STATS
+            /*
+             * approximate depth tracking with relaxed counters; the depth
+             * may be observed mid-update by concurrent pushers and poppers,
+             * so the high-water mark is a close bound rather than an exact
+             * maximum.
+             */
+            std::atomic <std::size_t> stat_depth_ {0};
+            std::atomic <std::size_t> stat_high_water_ {0};
+            std::atomic <std::size_t> stat_blocking_pushes_ {0};
+
+            void stats_note_push_ (std::size_t n = 1) noexcept
+            {
+                auto const d = this->stat_depth_.fetch_add (
+                    n, std::memory_order_relaxed
+                ) + n;
+
+                auto hw = this->stat_high_water_.load (
+                    std::memory_order_relaxed
+                );
+                while (hw < d &&
+                       !this->stat_high_water_.compare_exchange_weak (
+                            hw, d, std::memory_order_relaxed
+                       ))
+                {}
+            }
+
+            void stats_note_pop_ (void) noexcept
+            {
+                this->stat_depth_.fetch_sub (1, std::memory_order_relaxed);
+            }
+#else
+            void stats_note_push_ (std::size_t = 1) noexcept {}
+            void stats_note_pop_ (void) noexcept {}
+#endif
+
         public:
-            task_queue (void)
-                : tasks_ {}
+            explicit task_queue (eventcount * parked)
+                : ring_              {}
+                , priority_ring_     {}
+                , overflow_          {}
+                , priority_overflow_ {}
+                , parked_            {parked}
             {}
 
             task_queue (task_queue const &) = delete;
 
+            /*
+             * queues are moved only while the owning task_system is being
+             * constructed, before any producer or consumer thread can reach
+             * them, so the (unmovable) ring is always empty here.
+             */
             task_queue (task_queue && other) noexcept
-                : tasks_ (std::move (other).tasks_)
-                , done_  (other.done_.load ())
+                : ring_              {}
+                , priority_ring_     {}
+                , overflow_          (std::move (other).overflow_)
+                , priority_overflow_ (std::move (other).priority_overflow_)
+                , parked_            {other.parked_}
+                , done_              (other.done_.load ())
             {}
 
             void set_done (void)
             {
                 this->done_.store (true);
-                this->cv_.notify_all ();
+                this->parked_->notify_all ();
+            }
+
+            bool done (void) const noexcept
+            {
+                return this->done_.load ();
+            }
+
+#ifdef DSA_TASK_STATS
+            std::size_t stats_high_water (void) const noexcept
+            {
+                return this->stat_high_water_.load (
+                    std::memory_order_relaxed
+                );
+            }
+
+            std::size_t stats_blocking_pushes (void) const noexcept
+            {
+                return this->stat_blocking_pushes_.load (
+                    std::memory_order_relaxed
+                );
+            }
+#endif
+
+            /* emptiness check for the parking re-check path; exact for
+             * the rings, mutex-guarded for the overflow queues */
+            bool seems_empty (void)
+            {
+                if (!this->ring_.empty () ||
+                        !this->priority_ring_.empty ()) {
+                    return false;
+                }
+
+                std::lock_guard <std::mutex> hold (this->mutex_);
+                return this->overflow_.empty () &&
+                       this->priority_overflow_.empty ();
             }
 
             std::pair <bool, task> try_pop (void)
             {
+                task t;
+                if (this->priority_ring_.pop (t) || this->ring_.pop (t)) {
+                    this->stats_note_pop_ ();
+                    return std::make_pair (true, std::move (t));
+                }
+
                 std::unique_lock <std::mutex>
                     lock (this->mutex_, std::try_to_lock);
-                if (!lock || this->tasks_.empty ()) {
+                if (!lock) {
+                    return std::make_pair (false, task {});
+                }
+
+                auto & q = !this->priority_overflow_.empty ()
+                    ? this->priority_overflow_
+                    : this->overflow_;
+
+                if (q.empty ()) {
                     return std::make_pair (false, task {});
-                } else {
-                    auto t = std::move (this->tasks_.front ());
-                    this->tasks_.pop ();
-                    return std::make_pair (true, std::move (t));
                 }
+
+                auto o = std::move (q.front ());
+                q.pop ();
+                this->stats_note_pop_ ();
+                return std::make_pair (true, std::move (o));
             }
 
-            bool try_push (task & t)
+            bool try_push (task & t, enum priority pri = priority::normal)
             {
+                auto const pushed = pri == priority::high
+                    ? this->priority_ring_.push (std::move (t))
+                    : this->ring_.push (std::move (t));
+
+                if (pushed) {
+                    this->stats_note_push_ ();
+                    this->parked_->notify_one ();
+                    return true;
+                }
+
                 {
                     std::unique_lock <std::mutex>
                         lock (this->mutex_, std::try_to_lock);
                     if (!lock)
                         return false;
 
-                    this->tasks_.emplace (std::move (t));
+                    (pri == priority::high
+                        ? this->priority_overflow_
+                        : this->overflow_).emplace (std::move (t));
                 }
 
-                this->cv_.notify_one ();
+                this->stats_note_push_ ();
+                this->parked_->notify_one ();
                 return true;
             }
 
             std::pair <bool, task> pop (void)
             {
-                std::unique_lock <std::mutex> lock (this->mutex_);
-                while (this->tasks_.empty () && !this->done_)
-                    this->cv_.wait (lock);
+                task t;
 
-                if (this->tasks_.empty ())
-                    return std::make_pair (false, task {});
+                while (true) {
+                    if (this->priority_ring_.pop (t) ||
+                            this->ring_.pop (t)) {
+                        this->stats_note_pop_ ();
+                        return std::make_pair (true, std::move (t));
+                    }
+
+                    {
+                        std::unique_lock <std::mutex> lock (this->mutex_);
+
+                        auto & q = !this->priority_overflow_.empty ()
+                            ? this->priority_overflow_
+                            : this->overflow_;
+
+                        if (!q.empty ()) {
+                            auto o = std::move (q.front ());
+                            q.pop ();
+                            this->stats_note_pop_ ();
+                            return std::make_pair (true, std::move (o));
+                        }
+                    }
+
+                    if (this->done_) {
+                        return std::make_pair (false, task {});
+                    }
+
+                    /*
+                     * announce intent to park, then re-check: a push that
+                     * raced ahead of the announcement is caught by the
+                     * re-check, and every later push observes the
+                     * announced waiter and wakes it.
+                     */
+                    auto const generation = this->parked_->prepare_wait ();
+
+                    if (!this->seems_empty () || this->done_) {
+                        this->parked_->cancel_wait ();
+                        continue;
+                    }
 
-                auto t = std::move (this->tasks_.front ());
-                this->tasks_.pop ();
-                return std::make_pair (true, std::move (t));
+                    this->parked_->wait (generation);
+                }
             }
 
-            void push (task t)
+            void push (task t, enum priority pri = priority::normal)
             {
+#ifdef DSA_TASK_STATS
+                this->stat_blocking_pushes_.fetch_add (
+                    1, std::memory_order_relaxed
+                );
+#endif
+                auto const pushed = pri == priority::high
+                    ? this->priority_ring_.push (std::move (t))
+                    : this->ring_.push (std::move (t));
+
+                if (pushed) {
+                    this->stats_note_push_ ();
+                    this->parked_->notify_one ();
+                    return;
+                }
+
                 {
                     std::unique_lock <std::mutex> lock (this->mutex_);
-                    this->tasks_.emplace (std::move (t));
+                    (pri == priority::high
+                        ? this->priority_overflow_
+                        : this->overflow_).emplace (std::move (t));
+                }
+                this->stats_note_push_ ();
+                this->parked_->notify_one ();
+            }
+
+            /*
+             * inserts count tasks from the contiguous run starting at
+             * first; whatever does not fit in the ring spills to the
+             * overflow queue under a single lock acquisition, and one
+             * notification covers the whole run.
+             */
+            void push_batch (task * first, std::size_t count)
+            {
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (!this->ring_.push (std::move (first [i]))) {
+                        std::unique_lock <std::mutex> lock (this->mutex_);
+                        for (; i < count; ++i)
+                            this->overflow_.emplace (std::move (first [i]));
+                    }
+                }
+
+                if (count > 0) {
+                    this->stats_note_push_ (count);
+                    this->parked_->notify_all ();
                 }
-                this->cv_.notify_one ();
             }
         };
 
+        /*
+         * each worker owns a lock-free deque for the tasks it spawns itself
+         * (pushed and popped LIFO by the owner, stolen FIFO by idle
+         * workers), alongside an inbox queue receiving submissions from
+         * external threads.
+         */
+        /*
+         * shared parking lot: idle workers spin briefly and then park here
+         * rather than sleeping on per-queue condition variables, so a
+         * submission burst after an idle period performs targeted wakes
+         * while uncontended pushes pay one atomic load to observe that
+         * nobody is parked.
+         */
+        eventcount parked_;
+
+        std::vector <work_stealing_deque <task::task_concept *>> deques_;
         std::vector <task_queue> queues_;
         std::vector <std::thread> threads_;
         typename Allocator::template rebind <task::task_concept>::other
@@ -282,25 +1103,239 @@ namespace dsa
         std::size_t nthreads_;
         std::size_t current_index_ {0};
 
-        void run (std::size_t id)
+#ifdef DSA_TASK_STATS
+        /*
+         * per-worker counters, updated by the owning worker alone and read
+         * by snapshot with relaxed loads; allocated as an array since
+         * atomics are neither copyable nor movable.
+         */
+        struct worker_counters
         {
-            while (true) {
-                std::pair <bool, task> p;
+            std::atomic <std::size_t> tasks_executed {0};
+            std::atomic <std::size_t> steals_attempted {0};
+            std::atomic <std::size_t> steals_succeeded {0};
+            std::atomic <std::size_t> blocking_pops {0};
+        };
+
+        std::unique_ptr <worker_counters []> counters_;
+        std::atomic <std::size_t> blocking_submissions_ {0};
+#endif
+
+        /*
+         * identifies the calling thread as a worker of a particular
+         * task_system, so that tasks spawned from within a task land on the
+         * worker's own deque rather than bouncing through an inbox.
+         */
+        struct worker_context
+        {
+            task_system * system;
+            std::size_t id;
+        };
+
+        static worker_context & context_ (void) noexcept
+        {
+            static thread_local worker_context ctx {nullptr, 0};
+            return ctx;
+        }
+
+#ifdef DSA_TASK_STATS
+        void stats_count_executed_ (std::size_t id) noexcept
+        {
+            this->counters_ [id].tasks_executed.fetch_add (
+                1, std::memory_order_relaxed
+            );
+        }
+
+        void stats_count_steal_ (std::size_t id, bool succeeded) noexcept
+        {
+            (succeeded ? this->counters_ [id].steals_succeeded
+                       : this->counters_ [id].steals_attempted).fetch_add (
+                1, std::memory_order_relaxed
+            );
+        }
+
+        void stats_count_blocked_ (std::size_t id) noexcept
+        {
+            this->counters_ [id].blocking_pops.fetch_add (
+                1, std::memory_order_relaxed
+            );
+        }
+#else
+        void stats_count_executed_ (std::size_t) noexcept {}
+        void stats_count_steal_ (std::size_t, bool) noexcept {}
+        void stats_count_blocked_ (std::size_t) noexcept {}
+#endif
+
+        /*
+         * one scan over every source in preference order — the own deque,
+         * the own inbox, then steals of other deques and inboxes; executes
+         * at most one task and reports whether it found any.
+         */
+        bool poll_and_execute_ (std::size_t id)
+        {
+            /* own deque first: newest own task, no contention */
+            auto raw = this->deques_ [id].pop_bottom ();
+            if (raw) {
+                task t {raw};
+                t ();
+                this->stats_count_executed_ (id);
+                return true;
+            }
+
+            /* then the own inbox */
+            auto p = this->queues_ [id].try_pop ();
 
-                for (std::size_t k = 0; k < 10 * this->nthreads_; ++k) {
-                    p = this->queues_ [(id + k) % this->nthreads_].try_pop ();
-                    if (p.first)
+            if (!p.first) {
+                /* then steal: other deques before other inboxes */
+                for (std::size_t k = 1; k < this->nthreads_; ++k) {
+                    this->stats_count_steal_ (id, false);
+                    raw = this->deques_ [
+                        (id + k) % this->nthreads_
+                    ].steal ();
+                    if (raw)
                         break;
                 }
 
-                if (!p.first) {
-                    p = this->queues_ [id].pop ();
-                    if (!p.first)
-                        return;
+                if (raw) {
+                    task t {raw};
+                    t ();
+                    this->stats_count_steal_ (id, true);
+                    this->stats_count_executed_ (id);
+                    return true;
                 }
 
+                for (std::size_t k = 1;
+                     k < this->nthreads_ && !p.first; ++k)
+                {
+                    this->stats_count_steal_ (id, false);
+                    p = this->queues_ [
+                        (id + k) % this->nthreads_
+                    ].try_pop ();
+                    if (p.first) {
+                        this->stats_count_steal_ (id, true);
+                    }
+                }
+            }
+
+            if (p.first) {
                 p.second ();
+                this->stats_count_executed_ (id);
+                return true;
+            }
+
+            return false;
+        }
+
+        /* failed scans a worker burns through before parking; the brief
+         * spin keeps bursty workloads off the parking lot entirely */
+        static constexpr std::size_t park_spin_rounds = 16;
+
+        void run (std::size_t id)
+        {
+            auto & ctx = context_ ();
+            ctx.system = this;
+            ctx.id = id;
+
+            std::size_t idle_rounds = 0;
+
+            while (true) {
+                if (this->poll_and_execute_ (id)) {
+                    idle_rounds = 0;
+                    continue;
+                }
+
+                if (this->queues_ [id].done ()) {
+                    /*
+                     * drain the own inbox completely before leaving;
+                     * try_pop above may have failed on lock contention
+                     * rather than emptiness. Tasks left on other workers'
+                     * structures are drained by their owners, and nothing
+                     * can be added to this worker's deque once it stops
+                     * running tasks.
+                     */
+                    this->stats_count_blocked_ (id);
+                    auto p = this->queues_ [id].pop ();
+                    if (p.first) {
+                        p.second ();
+                        this->stats_count_executed_ (id);
+                        continue;
+                    }
+
+                    break;
+                }
+
+                if (idle_rounds < park_spin_rounds) {
+                    idle_rounds += 1;
+                    std::this_thread::yield ();
+                    continue;
+                }
+
+                /*
+                 * announce intent to park, then re-scan every source: a
+                 * task pushed before the announcement is found by the
+                 * re-scan, and every push after it observes the announced
+                 * waiter and pays for a wake.
+                 */
+                auto const generation = this->parked_.prepare_wait ();
+
+                if (this->poll_and_execute_ (id) ||
+                        this->queues_ [id].done ()) {
+                    this->parked_.cancel_wait ();
+                    idle_rounds = 0;
+                    continue;
+                }
+
+                this->stats_count_blocked_ (id);
+                this->parked_.wait (generation);
+                idle_rounds = 0;
             }
+
+            ctx.system = nullptr;
+            ctx.id = 0;
+        }
+
+        void schedule_ (task && t,
+                        std::size_t worker = no_affinity,
+                        enum priority pri = priority::normal)
+        {
+            if (worker != no_affinity) {
+                /*
+                 * affinity hint: place the task directly on the target
+                 * worker's queue. It remains stealable, so the hint biases
+                 * placement without risking starvation.
+                 */
+                auto const q = worker % this->nthreads_;
+                if (!this->queues_ [q].try_push (t, pri))
+                    this->queues_ [q].push (std::move (t), pri);
+                return;
+            }
+
+            auto & ctx = context_ ();
+
+            if (ctx.system == this && pri == priority::normal) {
+                /*
+                 * worker thread: owner-side deque push, with a wake so
+                 * that a parked worker can come steal it. High-priority
+                 * tasks bypass the (unprioritized) deque and go through
+                 * the inbox below instead.
+                 */
+                this->deques_ [ctx.id].push_bottom (t.release_ ());
+                this->parked_.notify_one ();
+                return;
+            }
+
+            auto const idx = this->current_index_++;
+            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
+                if (this->queues_ [(idx + k) % this->nthreads_]
+                        .try_push (t, pri))
+                    return;
+
+#ifdef DSA_TASK_STATS
+            this->blocking_submissions_.fetch_add (
+                1, std::memory_order_relaxed
+            );
+#endif
+            this->queues_ [idx % this->nthreads_].push (std::move (t), pri);
         }
 
     public:
@@ -315,9 +1350,16 @@ namespace dsa
             , alloc_    (alloc)
             , nthreads_ {nthreads}
         {
+#ifdef DSA_TASK_STATS
+            this->counters_.reset (new worker_counters [nthreads]);
+#endif
+            this->deques_.reserve (nthreads);
+            for (std::size_t th = 0; th < nthreads; ++th)
+                this->deques_.emplace_back ();
+
             this->queues_.reserve (nthreads);
             for (std::size_t th = 0; th < nthreads; ++th)
-                this->queues_.emplace_back (alloc);
+                this->queues_.emplace_back (&this->parked_);
 
             this->threads_.reserve (nthreads);
             for (std::size_t th = 0; th < nthreads; ++th)
@@ -353,24 +1395,184 @@ namespace dsa
                 std::forward <F> (f), std::forward <Args> (args)...
             );
 
-            auto const idx = this->current_index_++;
-            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
-                if (this->queues_ [(idx + k) % this->nthreads_]
-                        .try_push (t.first))
-                    return t.second;
-
-            this->queues_ [idx % this->nthreads_].push (std::move (t.first));
-            return t.second;
+            this->schedule_ (std::move (t.first));
+            return std::move (t.second);
         }
 
         void push (task && t)
         {
-            auto const idx = this->current_index_++;
-            for (std::size_t k = 0; k < 10 * this->nthreads_; ++k)
-                if (this->queues_ [(idx + k) % this->nthreads_].try_push (t))
-                    return;
+            this->schedule_ (std::move (t));
+        }
+
+        /*
+         * Enqueues a task with an affinity hint: it is placed on the queue
+         * of the given worker (modulo the worker count), where that worker
+         * finds it before resorting to stealing. Pair with current_worker
+         * to keep a continuation near the data its predecessor touched.
+         */
+        void push (task && t, std::size_t worker,
+                   enum priority pri = priority::normal)
+        {
+            this->schedule_ (std::move (t), worker, pri);
+        }
 
-            this->queues_ [idx % this->nthreads_].push (std::move (t));
+        /* Enqueues a task with a priority class and no affinity. */
+        void push (task && t, enum priority pri)
+        {
+            this->schedule_ (std::move (t), no_affinity, pri);
+        }
+
+        /*
+         * Creates and enqueues a task with an affinity hint, returning the
+         * future to its result; see push above.
+         */
+        template <class F, class ... Args>
+        auto push_at (std::size_t worker, F && f, Args && ... args)
+            -> typename std::remove_reference <
+                decltype (make_task (
+                    std::allocator_arg_t {}, this->alloc_,
+                    std::forward <F> (f), std::forward <Args> (args)...
+                ).second)
+            >::type
+        {
+            auto t = make_task (
+                std::allocator_arg_t {}, this->alloc_,
+                std::forward <F> (f), std::forward <Args> (args)...
+            );
+
+            this->schedule_ (std::move (t.first), worker);
+            return std::move (t.second);
+        }
+
+        /*
+         * Returns the index of the calling worker thread within this
+         * task_system, or no_affinity if the calling thread is not one of
+         * its workers; usable inside a running task to pin follow-up work
+         * near the data it has just touched.
+         */
+        std::size_t current_worker (void) const noexcept
+        {
+            auto & ctx = context_ ();
+            return ctx.system == this ? ctx.id : no_affinity;
+        }
+
+        /*
+         * Enqueues the tasks in [first, last) as one batch, partitioning it
+         * across the per-worker queues in contiguous chunks; each receiving
+         * queue is locked and notified at most once for its whole chunk
+         * rather than once per task. The tasks are moved from.
+         */
+        template <class InputIt>
+        void push_bulk (InputIt first, InputIt last)
+        {
+            std::vector <task> batch;
+            for (; first != last; ++first)
+                batch.emplace_back (std::move (*first));
+
+            this->push_bulk_ (batch);
+        }
+
+        /*
+         * Enqueues count tasks produced by successive calls to generate,
+         * batched as in the range overload.
+         */
+        template <class F>
+        auto push_bulk (std::size_t count, F && generate)
+            -> typename std::enable_if <
+                std::is_constructible <
+                    task, typename std::result_of <F ()>::type
+                >::value
+            >::type
+        {
+            std::vector <task> batch;
+            batch.reserve (count);
+            for (std::size_t i = 0; i < count; ++i)
+                batch.emplace_back (generate ());
+
+            this->push_bulk_ (batch);
+        }
+
+#ifdef DSA_TASK_STATS
+        /*
+         * Instrumentation snapshot, available when the library is compiled
+         * with DSA_TASK_STATS defined; without the flag none of the
+         * counters (or this interface) exist and the hot paths are
+         * untouched.
+         *
+         * The counters are maintained with relaxed atomics, so a snapshot
+         * taken while the system is running is a consistent-enough view
+         * for monitoring rather than an exact cut.
+         */
+        struct worker_stats
+        {
+            /* tasks this worker ran, from any source */
+            std::size_t tasks_executed;
+
+            /* steal probes of other workers' deques and inboxes */
+            std::size_t steals_attempted;
+            std::size_t steals_succeeded;
+
+            /* times the worker exhausted every queue and blocked */
+            std::size_t blocking_pops;
+
+            /* peak depth and blocking pushes of the worker's inbox */
+            std::size_t queue_high_water;
+            std::size_t queue_blocking_pushes;
+        };
+
+        struct system_stats
+        {
+            /*
+             * submissions that exhausted every try_push attempt and fell
+             * through to a blocking push; a rising value means the system
+             * is saturated
+             */
+            std::size_t blocking_submissions;
+            std::vector <worker_stats> workers;
+        };
+
+        system_stats snapshot (void) const
+        {
+            system_stats s;
+            s.blocking_submissions = this->blocking_submissions_.load (
+                std::memory_order_relaxed
+            );
+
+            s.workers.reserve (this->nthreads_);
+            for (std::size_t i = 0; i < this->nthreads_; ++i) {
+                auto const & c = this->counters_ [i];
+                s.workers.push_back (worker_stats {
+                    c.tasks_executed.load (std::memory_order_relaxed),
+                    c.steals_attempted.load (std::memory_order_relaxed),
+                    c.steals_succeeded.load (std::memory_order_relaxed),
+                    c.blocking_pops.load (std::memory_order_relaxed),
+                    this->queues_ [i].stats_high_water (),
+                    this->queues_ [i].stats_blocking_pushes ()
+                });
+            }
+
+            return s;
+        }
+#endif
+
+    private:
+        void push_bulk_ (std::vector <task> & batch)
+        {
+            if (batch.empty ())
+                return;
+
+            auto const start = this->current_index_++;
+            auto const chunk =
+                (batch.size () + this->nthreads_ - 1) / this->nthreads_;
+
+            std::size_t offset = 0;
+            for (std::size_t q = 0; offset < batch.size (); ++q) {
+                auto const n = std::min (chunk, batch.size () - offset);
+                this->queues_ [(start + q) % this->nthreads_].push_batch (
+                    batch.data () + offset, n
+                );
+                offset += n;
+            }
         }
     };
 }   // namespace dsa
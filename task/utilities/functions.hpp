@@ -178,19 +178,31 @@ namespace detail
         noexcept (noexcept (
             detail::apply_ (
                 std::forward <F> (f), std::forward <T> (t),
-                make_index_sequence <std::tuple_size <T>::value> {}
+                make_index_sequence <
+                    std::tuple_size <
+                        typename std::remove_reference <T>::type
+                    >::value
+                > {}
             )
         ))
         -> decltype (
             detail::apply_ (
                 std::forward <F> (f), std::forward <T> (t),
-                make_index_sequence <std::tuple_size <T>::value> {}
+                make_index_sequence <
+                    std::tuple_size <
+                        typename std::remove_reference <T>::type
+                    >::value
+                > {}
             )
         )
     {
         return detail::apply_ (
             std::forward <F> (f), std::forward <T> (t),
-            make_index_sequence <std::tuple_size <T>::value> {}
+            make_index_sequence <
+                std::tuple_size <
+                    typename std::remove_reference <T>::type
+                >::value
+            > {}
         );
     }
 }   // namespace utility
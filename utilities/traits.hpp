@@ -28,6 +28,27 @@
 #include <type_traits>
 
 
+#ifndef DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+#define DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+namespace dsa
+{
+    /*
+     * is_trivially_relocatable <T> is true when move constructing a T and
+     * destroying the source is equivalent to copying the object
+     * representation and abandoning the source without running its
+     * destructor. Every trivially copyable type qualifies, which is the
+     * default; user defined types whose moves only shuffle bytes may opt
+     * in by specializing this trait before instantiating the containers.
+     *
+     * the definition is repeated, behind this guard, in each header that
+     * relies on it so that the headers remain freestanding; all copies
+     * must stay identical.
+     */
+    template <class T>
+    struct is_trivially_relocatable : std::is_trivially_copyable <T> {};
+}   // namespace dsa
+#endif  // DSA_IS_TRIVIALLY_RELOCATABLE_DEFINED
+
 namespace dsa
 {
 namespace utility